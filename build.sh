@@ -14,13 +14,13 @@ if ! command -v g++ &> /dev/null; then
     exit 1
 fi
 
-# Check for X11 libraries
-echo "Checking for X11 development libraries..."
-if ! pkg-config --exists x11 xext xft xrender fontconfig; then
+# Check for X11 and SQLite libraries
+echo "Checking for X11 and SQLite development libraries..."
+if ! pkg-config --exists x11 xext xft xrender fontconfig sqlite3; then
     echo "Installing required libraries..."
     sudo apt-get update
     sudo apt-get install -y libx11-dev libxext-dev libxft-dev \
-                            libxrender-dev libfontconfig-dev
+                            libxrender-dev libfontconfig-dev libsqlite3-dev
 fi
 
 # Create build directory
@@ -30,6 +30,8 @@ proc create_menu_bar {} {
     menu .menubar.render -tearoff 0
     .menubar add cascade -label "Render" -menu .menubar.render
     .menubar.render add command -label "Render Animation" -command render_video
+    .menubar.render add command -label "Estimate Render Time" -command show_render_estimate
+    .menubar.render add command -label "Explain Render" -command show_render_explain
 
     # Help menu
     menu .menubar.help -tearoff 0
@@ -56,8 +58,12 @@ proc create_bottom_section {} {
     label .timeline.label -text "TIMELINE" -fg white -bg #202020 -font {Arial 10 bold}
     pack .timeline.label -side top -anchor w -padx 10 -pady 5
 
-    canvas .timeline.canvas -height 80 -bg #404040 -highlightthickness 0
+    canvas .timeline.canvas -height 80 -bg #404040 -highlightthickness 0 \
+        -xscrollcommand timeline_scrolled
+    scrollbar .timeline.scroll -orient horizontal -command {.timeline.canvas xview}
     pack .timeline.canvas -fill x -padx 10 -pady 5
+    pack .timeline.scroll -fill x -padx 10
+    bind .timeline.canvas <Configure> timeline_refresh
 
     # 3. Render frame (above timeline)
     frame .renderframe -bg #f8f8f8 -relief ridge -bd 2
@@ -72,9 +78,20 @@ proc create_bottom_section {} {
         -command render_video
     pack .renderframe.render -pady 10 -padx 20
 
+    button .renderframe.cancel -text "■ Cancel" \
+        -bg "#f44336" -fg white -font {Arial 10 bold} \
+        -activebackground "#d32f2f" \
+        -state disabled \
+        -command cancel_all_renders
+    pack .renderframe.cancel -pady 2
+
     label .renderframe.status -text "Ready to render" -bg #f8f8f8
     pack .renderframe.status -pady 5
 
+    # CPU, memory and I/O of the running renders, refreshed every second
+    label .renderframe.resources -text "" -bg #f8f8f8 -fg "#666666" -font {Arial 9}
+    pack .renderframe.resources -pady 2
+
     frame .renderframe.progress -bg #f8f8f8
     canvas .renderframe.progress.bar -width 200 -height 20 -bg white -relief sunken -bd 1
     label .renderframe.progress.text -text "0%" -bg #f8f8f8 -width 5
@@ -169,6 +186,22 @@ proc create_canvas_area {} {
     canvas .main.content.canvasarea.canvas -bg white -relief sunken -bd 2
     pack .main.content.canvasarea.canvas -fill both -expand 1
     
+    # Previews are rendered to fit the canvas
+    bind .main.content.canvasarea.canvas <Configure> {preview_canvas_resized %w %h}
+    
+    # Player controls for rendered videos, shown once one is loaded
+    set player .main.content.canvasarea.player
+    frame $player
+    button $player.play -text "▶" -width 3 -command player_toggle
+    scale $player.position -orient horizontal -from 0 -to 0 -showvalue 0 \
+        -variable ::player_frame -command player_scrubbed
+    label $player.time -text "0.00 / 0.00 s" -width 16
+    button $player.folder -text "Open Folder" -command open_video_folder
+    pack $player.play -side left -padx 2
+    pack $player.folder -side right -padx 2
+    pack $player.time -side right
+    pack $player.position -side left -fill x -expand 1
+    
     
     # Add canvas click handler to select equations
     #bind .main.content.canvasarea.canvas <Button-1> {
@@ -277,7 +310,11 @@ proc add_equation_from_entry {} {
         set x [expr {rand() * 400 - 200}]
         set y [expr {rand() * 300 - 150}]
         
-        set result [add_equation $eq_text $x $y]
+        # Invalid LaTeX is rejected up front; keep the text so it can be fixed
+        if {[catch {add_equation $eq_text $x $y} result]} {
+            .status.text configure -text [string map {"\n" "; "} $result]
+            return
+        }
         .status.text configure -text $result
         
         # Update preview and canvas
@@ -338,31 +375,303 @@ proc redraw_canvas {} {
     draw_equations_on_canvas
 }
 
-# Render procedures
-proc render_video {} {
-    puts "Starting video render..."
+# Still previews: C++ renders the scene's last frame shortly after every
+# edit and calls render_preview_finished with the PNG
+proc preview_canvas_resized {width height} {
+    # Largest 16:9 box inside the canvas, the shape of Manim's frame
+    set w [expr {min($width, $height * 16 / 9)}]
+    render_preview size $w [expr {$w * 9 / 16}]
+    .main.content.canvasarea.canvas coords preview [expr {$width / 2}] [expr {$height / 2}]
+    .main.content.canvasarea.canvas coords player [expr {$width / 2}] [expr {$height / 2}]
+}
+
+proc render_preview_finished {job_id state message image_path} {
+    if {$state eq "failed"} {
+        .status.text configure -text "Preview: $message"
+    }
+    if {$state ne "done"} {
+        return
+    }
+    # The scene changed since the video was rendered
+    player_close
+    if {[catch {image create photo ::preview_image -file $image_path} err]} {
+        puts "Preview not loaded: $err"
+        return
+    }
+    set canvas .main.content.canvasarea.canvas
+    $canvas delete preview
+    $canvas create image [expr {[winfo width $canvas] / 2}] [expr {[winfo height $canvas] / 2}] \
+        -image ::preview_image -tags preview
+    $canvas lower preview
+}
+
+# In-app playback: C++ decodes the video into ::player_image and calls
+# player_frame_shown for every frame it draws
+set ::player_frame 0
+set ::player_frames 0
+set ::player_fps 0
+
+# Job whose segments are streaming into the player, or 0
+set ::player_stream_job 0
+
+# Load a video over the canvas, starting `seconds` in; plays unless
+# `play` is 0. With `stream`, `path` is the first clip of a render still
+# running and more are appended as they finish.
+proc player_load {path {seconds 0} {play 1} {stream 0}} {
+    set canvas .main.content.canvasarea.canvas
+    set width [expr {max(16, min([winfo width $canvas], [winfo height $canvas] * 16 / 9))}]
+    # Even sizes keep ffmpeg's scaler happy
+    set width [expr {$width / 2 * 2}]
+    set height [expr {$width * 9 / 16 / 2 * 2}]
+    if {"::player_image" ni [image names]} {
+        image create photo ::player_image
+    }
+    set command [list video_player open $path ::player_image $width $height]
+    if {$stream} {
+        lappend command -stream
+    }
+    set ::player_stream_job 0
+    if {[catch $command info]} {
+        .status.text configure -text "Player: $info"
+        return
+    }
+    set ::player_fps [dict get $info fps]
+    set ::player_frames [dict get $info frames]
+    .main.content.canvasarea.player.position configure -to [expr {max(0, $::player_frames - 1)}]
+    $canvas delete player
+    $canvas create image [expr {[winfo width $canvas] / 2}] [expr {[winfo height $canvas] / 2}] \
+        -image ::player_image -tags player
+    pack .main.content.canvasarea.player -side bottom -fill x -before $canvas
+    if {$seconds > 0} {
+        video_player seek [expr {int(round($seconds * $::player_fps))}]
+    }
+    if {$play} {
+        video_player play
+        .main.content.canvasarea.player.play configure -text "❚❚"
+    } else {
+        .main.content.canvasarea.player.play configure -text "▶"
+    }
+}
+
+proc player_close {} {
+    set ::player_stream_job 0
+    video_player close
+    timeline_clear
+    .main.content.canvasarea.canvas delete player
+    pack forget .main.content.canvasarea.player
+}
+
+proc player_toggle {} {
+    if {[dict get [video_player state] playing]} {
+        video_player pause
+        .main.content.canvasarea.player.play configure -text "▶"
+    } else {
+        video_player play
+        .main.content.canvasarea.player.play configure -text "❚❚"
+    }
+}
+
+# Dragging the slider
+proc player_scrubbed {frame} {
+    video_player seek [expr {int($frame)}]
+}
+
+proc player_frame_shown {frame frame_count} {
+    set ::player_frame $frame
+    if {$frame_count != $::player_frames} {
+        # A stream grew
+        set ::player_frames $frame_count
+        .main.content.canvasarea.player.position configure -to [expr {max(0, $frame_count - 1)}]
+    }
+    if {$::player_fps > 0} {
+        .main.content.canvasarea.player.time configure -text [format "%.2f / %.2f s" \
+            [expr {$frame / $::player_fps}] [expr {$frame_count / $::player_fps}]]
+    }
+}
+
+proc player_finished {} {
+    .main.content.canvasarea.player.play configure -text "▶"
+}
+
+# Timeline: one thumbnail per animation of the video in the player, showing
+# the animation's last frame. Only the slots in view (plus a margin) have
+# canvas items and photo images; C++ decodes their frames in the
+# background and keeps recent ones in a memory-bounded cache, so
+# scrolling a long course never decodes it all.
+set ::timeline_video ""
+set ::timeline_starts {}
+set ::timeline_duration 0
+set ::timeline_first 1
+set ::timeline_thumb_width 128
+set ::timeline_thumb_height 72
+set ::timeline_slot_width 136
+set ::timeline_margin 4
+set ::timeline_refresh_pending 0
+array set ::timeline_key_slot {}
+
+# `first` is the number of the video's first animation in the scene, for
+# videos of a range
+proc timeline_load {video_path starts duration {first 1}} {
+    timeline_clear
+    set ::timeline_video $video_path
+    set ::timeline_starts $starts
+    set ::timeline_duration $duration
+    set ::timeline_first $first
+    set width [expr {[llength $starts] * $::timeline_slot_width}]
+    .timeline.canvas configure -scrollregion [list 0 0 $width 80]
+    .timeline.canvas xview moveto 0
+    timeline_refresh
+}
+
+proc timeline_clear {} {
+    foreach image [image names] {
+        if {[string match "::timeline_thumb_*" $image]} {
+            image delete $image
+        }
+    }
+    .timeline.canvas delete all
+    array unset ::timeline_key_slot
+    set ::timeline_video ""
+    set ::timeline_starts {}
+    .timeline.canvas configure -scrollregion {0 0 0 80}
+}
+
+proc timeline_scrolled {first last} {
+    .timeline.scroll set $first $last
+    timeline_refresh
+}
+
+# Coalesce scroll and resize events into one update per idle
+proc timeline_refresh {} {
+    if {!$::timeline_refresh_pending} {
+        set ::timeline_refresh_pending 1
+        after idle timeline_update
+    }
+}
+
+# Time of the frame a slot shows: just before the next animation starts
+proc timeline_slot_time {slot} {
+    set end [expr {$slot + 1 < [llength $::timeline_starts] ?
+                   [lindex $::timeline_starts [expr {$slot + 1}]] : $::timeline_duration}]
+    return [expr {max([lindex $::timeline_starts $slot], $end - 0.05)}]
+}
+
+proc timeline_update {} {
+    set ::timeline_refresh_pending 0
+    set count [llength $::timeline_starts]
+    if {$count == 0} {
+        return
+    }
+    set canvas .timeline.canvas
+    set slot_width $::timeline_slot_width
+    set first [expr {max(0, int([$canvas canvasx 0]) / $slot_width)}]
+    set last [expr {min($count - 1, int([$canvas canvasx [winfo width $canvas]]) / $slot_width)}]
+    set keep_first [expr {$first - $::timeline_margin}]
+    set keep_last [expr {$last + $::timeline_margin}]
     
-    .renderframe.status configure -text "Rendering..." -fg "#FF9800"
-    .renderframe.render configure -state disabled -text "⏳ Rendering..."
-    update
+    # Forget slots that scrolled well out of view
+    foreach item [$canvas find withtag slot] {
+        set slot [string range [lindex [$canvas gettags $item] 1] 5 end]
+        if {$slot < $keep_first || $slot > $keep_last} {
+            $canvas delete "slot_$slot"
+            catch {image delete ::timeline_thumb_$slot}
+        }
+    }
+    
+    set specs {}
+    for {set slot $first} {$slot <= $last} {incr slot} {
+        lappend specs [list $::timeline_video [timeline_slot_time $slot]]
+        if {[$canvas find withtag "slot_$slot"] ne ""} {
+            continue
+        }
+        set x [expr {$slot * $slot_width + 4}]
+        image create photo ::timeline_thumb_$slot \
+            -width $::timeline_thumb_width -height $::timeline_thumb_height
+        $canvas create rectangle $x 4 [expr {$x + $::timeline_thumb_width}] \
+            [expr {4 + $::timeline_thumb_height}] -fill #303030 -outline #606060 \
+            -tags [list slot "slot_$slot"]
+        $canvas create image $x 4 -anchor nw -image ::timeline_thumb_$slot \
+            -tags [list thumb "slot_$slot"]
+        $canvas create text [expr {$x + 4}] 6 -anchor nw -text [expr {$::timeline_first + $slot}] \
+            -fill white -font {Arial 8 bold} -tags [list label "slot_$slot"]
+        $canvas bind "slot_$slot" <Button-1> [list timeline_clicked $slot]
+        $canvas bind "slot_$slot" <Button-3> [list timeline_render_slot $slot]
+    }
     
-    pack .renderframe.progress
-    update_progress 10 "Generating script..."
+    # Asking again replaces the previous request, so only what is in
+    # view gets decoded
+    set keys [timeline_thumbnail want $specs $::timeline_thumb_width $::timeline_thumb_height]
+    array unset ::timeline_key_slot
+    set slot $first
+    foreach key $keys {
+        set ::timeline_key_slot($key) $slot
+        timeline_thumbnail put $key ::timeline_thumb_$slot
+        incr slot
+    }
+}
+
+proc timeline_thumbnail_ready {key ok} {
+    if {!$ok || ![info exists ::timeline_key_slot($key)]} {
+        return
+    }
+    set slot $::timeline_key_slot($key)
+    if {"::timeline_thumb_$slot" in [image names]} {
+        timeline_thumbnail put $key ::timeline_thumb_$slot
+    }
+}
+
+proc timeline_clicked {slot} {
+    set player [video_player state]
+    if {[dict get $player path] eq $::timeline_video && [dict get $player fps] > 0} {
+        video_player seek [expr {int(round([lindex $::timeline_starts $slot] * [dict get $player fps]))}]
+    }
+}
+
+# Re-render just this animation, for quick iteration on one step
+proc timeline_render_slot {slot} {
+    set animation [expr {$::timeline_first + $slot}]
+    render_video $animation $animation
+}
+
+# Render procedures
+# Renders run on C++ worker threads; render_scene hands back a job id and
+# render_job_finished is called from the event loop when the job ends.
+array set ::render_jobs {}
+array set ::render_last_progress {}
+set ::last_video_path ""
+
+# Progressive renders show a -ql draft first and swap in the -qh version
+# rendered in the background; ::render_upgrades maps final job -> draft
+set ::render_progressive 1
+array set ::render_upgrades {}
+
+# Seconds without a progress report before a job is flagged as stalled
+set ::render_stall_seconds 20
+
+# With `first` and `last`, only those animations (counted from 1) are
+# rendered
+proc render_video {{first 0} {last 0}} {
+    puts "Starting video render..."
     
+    set range {}
+    if {$first > 0} {
+        set range [list --animations $first $last]
+    }
     try {
-        set result [render_scene]
-        
-        update_progress 100 "Render complete!"
-        .renderframe.status configure -text $result -fg "#4CAF50"
-        
-        set response [tk_messageBox \
-            -message "Video rendered successfully!\n\nOpen video folder?" \
-            -type yesno \
-            -icon info]
-        
-        if {$response eq "yes"} {
-            open_video_folder
+        if {$::render_progressive} {
+            lassign [render_scene progressive {*}$range] job_id final_id
+            set ::render_upgrades($final_id) $job_id
+            set ::render_last_progress($final_id) [clock milliseconds]
+        } else {
+            set job_id [render_scene {*}$range]
         }
+        set ::render_jobs($job_id) [clock milliseconds]
+        set ::render_last_progress($job_id) [clock milliseconds]
+        
+        pack .renderframe.progress
+        show_render_started $job_id ""
+        update_render_controls
+        after 1000 check_render_stalls
         
     } on error {errMsg} {
         .renderframe.status configure -text "Render failed: $errMsg" -fg "#f44336"
@@ -370,9 +679,299 @@ proc render_video {} {
             -message "Render failed:\n$errMsg" \
             -type ok \
             -icon error
-    } finally {
-        .renderframe.render configure -state normal -text "▶ Render Video"
-        after 3000 {pack forget .renderframe.progress}
+    }
+}
+
+# Status line for a job that has no progress to show yet; the estimate
+# arrives once the job has been planned (see render_job_planned)
+proc show_render_started {job_id estimate} {
+    if {$estimate ne ""} {
+        set estimate " ($estimate)"
+    }
+    if {[dict get [get_render_status $job_id] state] eq "queued"} {
+        update_progress 0 "Job #$job_id queued$estimate..."
+    } else {
+        update_progress 0 "Rendering job #$job_id$estimate..."
+    }
+}
+
+# Every job still queued or running: the renders themselves and the
+# background -qh upgrades of progressive ones, which outlive their drafts
+proc pending_render_jobs {} {
+    return [lsort -integer [concat [array names ::render_jobs] [array names ::render_upgrades]]]
+}
+
+# How the status line names a job; upgrades go by their draft's number
+proc render_job_label {job_id} {
+    if {[info exists ::render_upgrades($job_id)]} {
+        return "Job #$::render_upgrades($job_id) (high quality)"
+    }
+    return "Job #$job_id"
+}
+
+# Called from C++ once a submitted job's time has been estimated; shown
+# for the latest job until it reports progress
+proc render_job_planned {job_id seconds} {
+    if {![info exists ::render_jobs($job_id)] ||
+        $job_id != [lindex [lsort -integer [array names ::render_jobs]] end] ||
+        [dict get [get_render_status $job_id] percent] > 0} {
+        return
+    }
+    set estimate [format_estimate $seconds]
+    if {$estimate ne ""} {
+        show_render_started $job_id $estimate
+    }
+}
+
+# "about 1m 20s" for an estimate in seconds, empty when there is none
+proc format_estimate {seconds} {
+    if {$seconds < 0} {
+        return ""
+    }
+    set seconds [expr {max(1, round($seconds))}]
+    if {$seconds < 60} {
+        return "about ${seconds}s"
+    }
+    return "about [expr {$seconds / 60}]m [expr {$seconds % 60}]s"
+}
+
+# What rendering the scene would take at draft and final quality, from
+# the renders done on this machine so far
+proc show_render_estimate {} {
+    set lines {}
+    foreach {quality name} {-ql "Draft (-ql)" -qh "Final (-qh)"} {
+        if {[catch {render_estimate $quality} estimate]} {
+            lappend lines "$name: $estimate"
+            continue
+        }
+        set basis [dict get $estimate basis]
+        if {$basis eq "cache"} {
+            lappend lines "$name: already rendered"
+        } elseif {$basis eq "none"} {
+            lappend lines "$name: unknown until something has been rendered"
+        } else {
+            lappend lines "$name: [format_estimate [dict get $estimate seconds]]\
+                ([dict get $estimate animations] animations to render,\
+                from [dict get $estimate samples] past renders)"
+        }
+    }
+    tk_messageBox -title "Render Time" -message [join $lines "\n"] -type ok -icon info
+}
+
+# What the next Render Animation would rebuild, and why
+proc show_render_explain {} {
+    set quality {}
+    if {$::render_progressive} {
+        set quality progressive
+    }
+    if {[catch {render_scene {*}$quality --explain} assets]} {
+        tk_messageBox -title "Explain Render" -message $assets -type ok -icon error
+        return
+    }
+    set lines {}
+    set rebuilt 0
+    foreach asset $assets {
+        if {![dict get $asset rebuild]} {
+            continue
+        }
+        incr rebuilt
+        if {$rebuilt <= 20} {
+            lappend lines "[dict get $asset quality] [dict get $asset node]: [dict get $asset reason]"
+        }
+    }
+    if {$rebuilt > 20} {
+        lappend lines "... and [expr {$rebuilt - 20}] more"
+    }
+    set summary "$rebuilt of [llength $assets] assets to rebuild"
+    if {$rebuilt == 0} {
+        set summary "Everything is up to date ([llength $assets] assets)"
+    }
+    tk_messageBox -title "Explain Render" -message $summary -detail [join $lines "\n"] -type ok -icon info
+}
+
+proc render_job_finished {job_id state message video_path} {
+    if {[info exists ::render_upgrades($job_id)]} {
+        render_upgrade_finished $job_id $state $message $video_path
+        return
+    }
+    if {![info exists ::render_jobs($job_id)]} {
+        return
+    }
+    set elapsed [expr {([clock milliseconds] - $::render_jobs($job_id)) / 1000.0}]
+    unset ::render_jobs($job_id)
+    unset -nocomplain ::render_last_progress($job_id)
+    update_render_controls
+    
+    # Segments played while rendering: swap in the joined video at the
+    # same point, or let what did render play out
+    set seconds 0
+    set play 1
+    if {$::player_stream_job == $job_id} {
+        set ::player_stream_job 0
+        set player [video_player state]
+        if {$state eq "done" && [dict get $player fps] > 0} {
+            set seconds [expr {[dict get $player frame] / [dict get $player fps]}]
+            set play [dict get $player playing]
+        } else {
+            video_player finish
+        }
+    }
+    
+    if {$state eq "cancelled"} {
+        .renderframe.status configure -text "Job #$job_id: $message" -fg "#2196F3"
+    } elseif {$state eq "done"} {
+        set ::last_video_path $video_path
+        update_progress 100 "Render complete!"
+        set cache_note ""
+        set status [get_render_status $job_id]
+        if {[dict get $status cache] eq "hit"} {
+            set cache_note ", cache hit"
+        }
+        if {[dict get $status upgrade] != 0} {
+            append cache_note ", draft; high quality in background"
+        }
+        .renderframe.status configure -text "Job #$job_id: $message ([format %.1f $elapsed]s$cache_note)" -fg "#4CAF50"
+        player_load $video_path $seconds $play
+        timeline_load $video_path [dict get $status animations] [dict get $status duration] \
+            [lindex [dict get $status range] 0]
+    } else {
+        .renderframe.status configure -text "Job #$job_id: $message" -fg "#f44336"
+        tk_messageBox \
+            -message "Render failed:\n$message" \
+            -type ok \
+            -icon error
+    }
+    
+    hide_idle_progress
+}
+
+# Hide the progress bar a moment after the last job, upgrades included,
+# has ended
+proc hide_idle_progress {} {
+    if {[llength [pending_render_jobs]] == 0} {
+        after 3000 {
+            if {[llength [pending_render_jobs]] == 0} {pack forget .renderframe.progress}
+        }
+    }
+}
+
+# The background -qh job of a progressive render ended; its video replaces
+# the draft
+proc render_upgrade_finished {job_id state message video_path} {
+    set draft_id $::render_upgrades($job_id)
+    unset ::render_upgrades($job_id)
+    unset -nocomplain ::render_last_progress($job_id)
+    update_render_controls
+    hide_idle_progress
+    if {$state eq "done"} {
+        set ::last_video_path $video_path
+        .renderframe.status configure -text "Job #$draft_id: high quality version ready" -fg "#4CAF50"
+        # Swap it in at the same point of the animation, if the draft is
+        # still on screen
+        set player [video_player state]
+        if {[dict get $player path] ne "" && [dict get $player fps] > 0} {
+            player_load $video_path [expr {[dict get $player frame] / [dict get $player fps]}] \
+                [dict get $player playing]
+            set status [get_render_status $job_id]
+            timeline_load $video_path [dict get $status animations] [dict get $status duration] \
+                [lindex [dict get $status range] 0]
+        }
+    } elseif {$state eq "failed"} {
+        .renderframe.status configure -text "Job #$draft_id: high quality render failed: $message" -fg "#f44336"
+    } else {
+        .renderframe.status configure -text "Job #$draft_id (high quality): $message" -fg "#2196F3"
+    }
+}
+
+# A segmented render's clips arrive in scene order while it runs; play
+# them as they come, so the preview starts as soon as the first segment is
+# done rather than when the whole scene is
+proc render_segment_ready {job_id index count clip} {
+    if {![info exists ::render_jobs($job_id)]} {
+        return
+    }
+    if {$index == 0} {
+        player_load $clip 0 1 1
+        set ::player_stream_job $job_id
+    } elseif {$::player_stream_job == $job_id} {
+        if {[catch {video_player append $clip} error]} {
+            puts "Could not stream segment [expr {$index + 1}]: $error"
+            set ::player_stream_job 0
+            video_player finish
+            return
+        }
+    } else {
+        return
+    }
+    if {$index == $count - 1} {
+        video_player finish
+    }
+}
+
+# Called (rate limited) from C++ as Manim's progress bars advance
+proc render_job_progress {job_id percent animation animation_count frame frame_count fps} {
+    if {![info exists ::render_last_progress($job_id)]} {
+        return
+    }
+    set ::render_last_progress($job_id) [clock milliseconds]
+    # A background upgrade only takes the bar once no draft is using it
+    if {[info exists ::render_upgrades($job_id)]} {
+        if {[array size ::render_jobs] > 0} {
+            return
+        }
+        pack .renderframe.progress
+    }
+    update_progress $percent \
+        "[render_job_label $job_id]: animation $animation/$animation_count, frame $frame/$frame_count ($fps fps)"
+}
+
+# Flag jobs whose Manim output has gone quiet and show what the running
+# ones use; reschedules itself while any job is still running
+proc check_render_stalls {} {
+    after cancel check_render_stalls
+    if {[llength [pending_render_jobs]] == 0} {
+        .renderframe.resources configure -text ""
+        return
+    }
+    set now [clock milliseconds]
+    set usage {}
+    foreach job_id [pending_render_jobs] {
+        set status [get_render_status $job_id]
+        # Waiting in the queue is not a stall
+        if {[dict get $status state] eq "queued"} {
+            set ::render_last_progress($job_id) $now
+            continue
+        }
+        set r [dict get $status resources]
+        lappend usage [format "#%d: %d proc, %.0f%% CPU, %.0f MB (peak %.0f), I/O %.1f/%.1f MB" \
+            $job_id [dict get $r processes] [dict get $r cpu] [dict get $r rss_mb] \
+            [dict get $r peak_mb] [dict get $r read_mb] [dict get $r write_mb]]
+        set quiet [expr {($now - $::render_last_progress($job_id)) / 1000}]
+        if {$quiet >= $::render_stall_seconds} {
+            .renderframe.status configure \
+                -text "[render_job_label $job_id]: no progress for ${quiet}s (stalled?)" -fg "#f44336"
+        }
+    }
+    .renderframe.resources configure -text [join $usage "\n"]
+    after 1000 check_render_stalls
+}
+
+proc cancel_all_renders {} {
+    foreach job_id [concat [array names ::render_jobs] [array names ::render_upgrades]] {
+        cancel_render $job_id
+    }
+    .renderframe.status configure -text "Cancelling..." -fg "#FF9800"
+}
+
+proc update_render_controls {} {
+    set active [llength [pending_render_jobs]]
+    if {$active > 0} {
+        .renderframe.render configure -text "▶ Render Video ($active running)"
+        .renderframe.cancel configure -state normal
+        .renderframe.status configure -fg "#FF9800"
+    } else {
+        .renderframe.render configure -text "▶ Render Video"
+        .renderframe.cancel configure -state disabled
     }
 }
 
@@ -388,11 +987,13 @@ proc update_progress {percent message} {
     
     .renderframe.progress.text configure -text "$percent%"
     .renderframe.status configure -text $message
-    update
 }
 
 proc open_video_folder {} {
     set video_dir "media/videos/render_output/"
+    if {$::last_video_path ne ""} {
+        set video_dir [file dirname $::last_video_path]
+    }
     
     if {[file exists $video_dir]} {
         if {[catch {exec xdg-open $video_dir} err]} {
@@ -421,6 +1022,7 @@ proc test_render {} {
 
 proc clear_scene {} {
     catch {clear_all_equations}
+    player_close
     .main.content.canvasarea.canvas delete all
     .renderframe.status configure -text "Scene cleared" -fg "#2196F3"
 }
@@ -433,9 +1035,9 @@ proc test_equation_feature {} {
     set eqs [list_equations]
     puts "Equations in scene: $eqs"
     
-    render_scene
+    set job_id [render_scene]
     
-    puts "Check render_output.py and media/videos/"
+    puts "Render job #$job_id started, check render_output_$job_id.py and media/videos/"
 }
 
 # Dummy procedures for menu commands (implement these in C++ later)
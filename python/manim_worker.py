@@ -0,0 +1,362 @@
+# python/manim_worker.py - Long-lived Manim renderer for AmrMathMaker
+#
+# Started by the C++ ManimWorkerPool. Importing manim costs a few seconds,
+# so this process does it once and then renders requests from stdin, one
+# JSON object per line:
+#
+#   {"job": 3, "script": "render_output_3.py", "quality": "-ql",
+#    "scenes": ["Segment2", "Segment3"], "tex": ["x^2", "\\frac{a}{b}"]}
+#   {"cmd": "ping"}
+#
+# Manim's own log and progress output goes to stdout/stderr as usual. When a
+# request is finished a marker line is printed so the C++ side knows where
+# this request's output ends. "scenes" defaults to ["GeneratedScene"];
+# "videos" lists one file per scene, in order, and "video" is the last.
+# "tex" snippets are typeset before any scene (see compile_tex_batch), and
+# "tex_files" gives the file each one has in Manim's tex cache.
+# "still": true saves only each scene's last frame and lists the PNGs in
+# "videos"; "resolution": [width, height] overrides the quality's size.
+#
+#   @@AMR_DONE {"ok": true, "video": "/.../Segment3.mp4", "videos": [...],
+#               "tex_compiled": 2, "tex_files": ["/.../media/Tex/1f0c...svg", ...]}
+#
+# Each scene's movie is also announced as soon as it is written, so the
+# app can start playing the first segments while later ones render:
+#
+#   @@AMR_SCENE {"index": 0, "video": "/.../Segment2.mp4"}
+
+import glob
+import hashlib
+import importlib.util
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import traceback
+from pathlib import Path
+
+READY = "@@AMR_READY"
+DONE = "@@AMR_DONE"
+SCENE = "@@AMR_SCENE"
+
+QUALITY = {
+    "-ql": "low_quality",
+    "-qm": "medium_quality",
+    "-qh": "high_quality",
+    "-qp": "production_quality",
+    "-qk": "fourk_quality",
+}
+
+
+def emit(marker, payload):
+    # The app stops reading at the marker on stdout and then only drains
+    # what is already in the stderr pipe, so stderr is flushed first
+    sys.stderr.flush()
+    sys.stdout.write("\n%s %s\n" % (marker, json.dumps(payload, ensure_ascii=False)))
+    sys.stdout.flush()
+
+
+def load_module(script_path, module_name):
+    spec = importlib.util.spec_from_file_location(module_name, script_path)
+    module = importlib.util.module_from_spec(spec)
+    sys.modules[module_name] = module
+    try:
+        spec.loader.exec_module(module)
+    finally:
+        sys.modules.pop(module_name, None)
+    return module
+
+
+def tex_expression(snippet):
+    # MathTex cleans the string up (fillers for a trailing ^, balanced
+    # \left/\right, ...) before hashing it; do the same so the names match
+    try:
+        from manim import SingleStringMathTex
+        return SingleStringMathTex._get_modified_expression(
+            object.__new__(SingleStringMathTex), snippet)
+    except Exception:
+        return snippet.strip()
+
+
+# Engines whose preamble can be dumped with -ini and loaded back with -fmt;
+# LuaTeX formats need Lua callbacks restored and are left alone
+FORMAT_ENGINES = ("latex", "pdflatex", "xelatex")
+
+# Preamble hash -> dumped format path, or None when building it failed
+formats = {}
+
+
+def split_document(code):
+    """(preamble, rest) of a LaTeX document, split at \\begin{document}"""
+    start = code.index("\\begin{document}")
+    return code[:start], code[start:]
+
+
+def preamble_format(preamble, compiler, tex_dir):
+    """A format file with `preamble` already loaded, built the first time a
+    preamble is seen. It lives in media/Tex/formats under a hash of the
+    engine and preamble text, so a changed template gets a fresh one."""
+    if compiler not in FORMAT_ENGINES:
+        return None
+    key = hashlib.sha256((compiler + "\n" + preamble).encode()).hexdigest()[:16]
+    if key in formats:
+        return formats[key]
+
+    name = "amr-" + key
+    format_dir = os.path.join(tex_dir, "formats")
+    fmt = os.path.join(format_dir, name + ".fmt")
+    if not os.path.exists(fmt):
+        os.makedirs(format_dir, exist_ok=True)
+        work_dir = tempfile.mkdtemp(prefix="amr_fmt_", dir=format_dir)
+        try:
+            with open(os.path.join(work_dir, name + ".tex"), "w", encoding="utf-8") as f:
+                f.write(preamble + "\\dump\n")
+            subprocess.run([compiler, "-ini", "-interaction=batchmode", "-halt-on-error",
+                            "-jobname=" + name, "-output-directory=" + work_dir,
+                            "&" + compiler, name + ".tex"],
+                           stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL,
+                           cwd=work_dir, check=True)
+            os.replace(os.path.join(work_dir, name + ".fmt"), fmt)
+        except (OSError, subprocess.CalledProcessError) as e:
+            print("Could not build TeX format for %s: %s" % (compiler, e), file=sys.stderr)
+            formats[key] = None
+            return None
+        finally:
+            shutil.rmtree(work_dir, ignore_errors=True)
+
+    formats[key] = fmt
+    return fmt
+
+
+def typeset(document, directory, jobname, compiler, output_format):
+    """Compile `document` to directory/jobname + output_format. The body
+    is compiled against a dumped format of the preamble when possible, so
+    TeX skips re-reading amsmath and friends; otherwise, or if that fails,
+    the whole document is compiled as usual."""
+    command = [compiler, "-interaction=batchmode", "-halt-on-error",
+               "-jobname=" + jobname, "-output-directory=" + directory]
+    command.insert(1, "-no-pdf" if output_format == ".xdv" else "-output-format=dvi")
+    output = os.path.join(directory, jobname + output_format)
+
+    preamble, body = split_document(document)
+    fmt = preamble_format(preamble, compiler, config_tex_dir())
+    format_failed = False
+    if fmt:
+        body_file = os.path.join(directory, jobname + ".body.tex")
+        with open(body_file, "w", encoding="utf-8") as f:
+            f.write(body)
+        try:
+            subprocess.run(command[:1] + ["-fmt=" + fmt] + command[1:] + [body_file],
+                           stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL,
+                           cwd=directory, check=True)
+            return output
+        except subprocess.CalledProcessError:
+            format_failed = True
+        finally:
+            os.remove(body_file)
+
+    tex_file = os.path.join(directory, jobname + ".full.tex")
+    with open(tex_file, "w", encoding="utf-8") as f:
+        f.write(document)
+    try:
+        subprocess.run(command + [tex_file], stdout=subprocess.DEVNULL,
+                       stderr=subprocess.DEVNULL, cwd=directory, check=True)
+    finally:
+        os.remove(tex_file)
+
+    if format_failed:
+        # The document is fine, so the format is what broke (a TeX Live
+        # update invalidates dumped formats); stop using it
+        for key, path in formats.items():
+            if path == fmt:
+                formats[key] = None
+        try:
+            os.remove(fmt)
+        except OSError:
+            pass
+    return output
+
+
+def config_tex_dir():
+    from manim import config
+    tex_dir = str(config.get_dir("tex_dir"))
+    os.makedirs(tex_dir, exist_ok=True)
+    return tex_dir
+
+
+def install_format_compiler():
+    """Route Manim's own per-MathTex compiles through typeset(), keeping
+    its compiler as the fallback (it also writes the error report for a
+    snippet that doesn't compile)."""
+    try:
+        import manim.utils.tex_file_writing as tex_file_writing
+    except ImportError:
+        return
+    manim_compile_tex = getattr(tex_file_writing, "compile_tex", None)
+    if manim_compile_tex is None:
+        return
+
+    def compile_tex(tex_file, tex_compiler, output_format):
+        if output_format in (".dvi", ".xdv"):
+            try:
+                with open(tex_file, encoding="utf-8") as f:
+                    document = f.read()
+                directory, name = os.path.split(os.path.splitext(str(tex_file))[0])
+                return Path(typeset(document, directory, name, tex_compiler, output_format))
+            except (OSError, ValueError, subprocess.CalledProcessError):
+                pass
+        return manim_compile_tex(tex_file, tex_compiler, output_format)
+
+    tex_file_writing.compile_tex = compile_tex
+
+
+def tex_cache_entry(snippet):
+    """The TeX document Manim writes for a MathTex of `snippet` with the
+    current template, and the SVG it keeps the result in."""
+    from manim import config
+    from manim.utils.tex_file_writing import tex_hash
+
+    code = config["tex_template"].get_texcode_for_expression_in_env(tex_expression(snippet), "align*")
+    return code, os.path.abspath(os.path.join(config_tex_dir(), tex_hash(code) + ".svg"))
+
+
+def compile_tex_batch(snippets):
+    """Typeset every snippet missing from Manim's tex cache as one page of a
+    single document, so TeX starts once rather than once per MathTex, and
+    drop each page into the cache as the SVG Manim would have produced.
+
+    Manim looks an expression up as media/Tex/<tex_hash(full document)>.svg
+    and only runs latex + dvisvgm when that file is missing. Anything that
+    doesn't fit (an unknown template, a TeX error, a page count mismatch)
+    is left to Manim, which compiles it the slow way and reports errors per
+    equation. Returns how many snippets were compiled."""
+    from manim import config
+
+    template = config["tex_template"]
+    tex_dir = config_tex_dir()
+
+    pending = []
+    for snippet in dict.fromkeys(snippets):
+        code, svg = tex_cache_entry(snippet)
+        if not os.path.exists(svg):
+            pending.append((code, svg))
+    if not pending:
+        return 0
+
+    # standalone's multi mode puts each standalone environment on a page
+    # of its own, cropped exactly like the single equation documents
+    match = re.match(r"\\documentclass(\[[^]]*\])?\{standalone\}", template.documentclass.strip())
+    output_format = template.output_format
+    if not match or output_format not in (".dvi", ".xdv"):
+        return 0
+    options = (match.group(1) or "[]")[1:-1]
+    documentclass = "\\documentclass[%s]{standalone}" % ",".join(filter(None, [options, "multi"]))
+
+    def body(code):
+        start = code.index("\\begin{document}") + len("\\begin{document}")
+        return code[start:code.rindex("\\end{document}")]
+
+    first = pending[0][0]
+    preamble = first[:first.index("\\begin{document}")].replace(template.documentclass.strip(), documentclass, 1)
+    pages = ["\\begin{standalone}%s\\end{standalone}\n" % body(code) for code, _ in pending]
+    document = preamble + "\\begin{document}\n" + "".join(pages) + "\\end{document}\n"
+
+    work_dir = tempfile.mkdtemp(prefix="amr_tex_", dir=tex_dir)
+    try:
+        output = typeset(document, work_dir, "batch", template.tex_compiler, output_format)
+        subprocess.run(["dvisvgm", output,
+                        "--page=1-", "-n", "-v", "0",
+                        "-o", os.path.join(work_dir, "page-%p.svg")],
+                       stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, check=True)
+
+        page_files = glob.glob(os.path.join(work_dir, "page-*.svg"))
+        page_files.sort(key=lambda path: int(re.search(r"(\d+)\.svg$", path).group(1)))
+        if len(page_files) != len(pending):
+            print("Batch LaTeX produced %d pages for %d snippets, skipping"
+                  % (len(page_files), len(pending)), file=sys.stderr)
+            return 0
+
+        # Rename into place so a concurrent render never reads half a file
+        for page_file, (_, svg) in zip(page_files, pending):
+            os.replace(page_file, svg)
+        return len(pending)
+    finally:
+        shutil.rmtree(work_dir, ignore_errors=True)
+
+
+def render(request):
+    from manim import tempconfig
+
+    script_path = request["script"]
+    quality = QUALITY.get(request.get("quality", "-ql"), "low_quality")
+    module_name = os.path.splitext(os.path.basename(script_path))[0]
+
+    # input_file decides media/videos/<stem>/, matching `manim <script>`
+    overrides = {"quality": quality, "input_file": script_path}
+    if request.get("resolution"):
+        overrides["pixel_width"], overrides["pixel_height"] = request["resolution"]
+    still = bool(request.get("still"))
+    if still:
+        overrides.update({"save_last_frame": True, "write_to_movie": False})
+    videos = []
+    tex_compiled = 0
+    tex_files = []
+    with tempconfig(overrides):
+        if request.get("tex"):
+            try:
+                tex_compiled = compile_tex_batch(request["tex"])
+            except Exception as e:
+                print("Batch LaTeX compile failed: %s" % e, file=sys.stderr)
+            # Manim typesets whatever the batch left out into the same files
+            try:
+                tex_files = [tex_cache_entry(snippet)[1] for snippet in request["tex"]]
+            except Exception:
+                pass
+
+        scenes = request.get("scenes", ["GeneratedScene"])
+        if scenes:
+            module = load_module(script_path, module_name)
+            for name in scenes:
+                scene = getattr(module, name)()
+                scene.render()
+                writer = scene.renderer.file_writer
+                videos.append(str(writer.image_file_path if still else writer.movie_file_path))
+                if not still:
+                    emit(SCENE, {"index": len(videos) - 1, "video": videos[-1]})
+    return videos, tex_compiled, tex_files
+
+
+def main():
+    import manim  # the slow part, paid once per worker
+
+    install_format_compiler()
+    emit(READY, {"version": manim.__version__})
+
+    for line in sys.stdin:
+        line = line.strip()
+        if not line:
+            continue
+        try:
+            request = json.loads(line)
+        except ValueError as e:
+            emit(DONE, {"ok": False, "error": "bad request: %s" % e})
+            continue
+
+        if request.get("cmd") == "ping":
+            emit(DONE, {"ok": True, "version": manim.__version__})
+            continue
+
+        try:
+            videos, tex_compiled, tex_files = render(request)
+            emit(DONE, {"ok": True, "video": videos[-1] if videos else "",
+                        "videos": videos, "tex_compiled": tex_compiled, "tex_files": tex_files})
+        except Exception as e:
+            traceback.print_exc()
+            emit(DONE, {"ok": False, "error": "%s: %s" % (type(e).__name__, e)})
+
+
+if __name__ == "__main__":
+    main()
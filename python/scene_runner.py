@@ -0,0 +1,144 @@
+# python/scene_runner.py - Builds AmrMathMaker scenes from scene data
+#
+# The C++ side describes a render as data instead of generating Python per
+# equation. Each render writes a small fixed stub script and a JSON file
+# next to it (render_output_3.py, render_output_3.scene.json):
+#
+#   {"version": 1,
+#    "scenes": [{"name": "GeneratedScene", "kind": "full"},
+#               {"name": "Segment2", "kind": "segment", "index": 2}],
+#    "equations": [{"latex": "x^2", "x": 0, "y": 1, "color": "blue",
+#                   "scale": 1, "animation": "write", "wait": 0.5},
+#                  {"latex": "x^3", ..., "animation": "transform_from_copy",
+#                   "from": 0, "wait": 0.5}]}
+#
+# The stub calls scene_classes(), which defines one Scene subclass per
+# entry in "scenes" in the stub's module, where Manim's CLI and the warm
+# worker look for them. Kinds:
+#   full     every equation's animation and wait, in order; with "first",
+#            equations before it are added as they end up and only the
+#            animations from "first" on are played (a range render)
+#   segment  equations 0..index-1 added as they end up, then animation index
+#   still    every equation added, nothing played (for -s previews)
+
+import json
+
+# Bump together with ManimScript::FORMAT_VERSION
+FORMAT_VERSION = 1
+
+
+def load_scene_data(path):
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    version = data.get("version")
+    if version != FORMAT_VERSION:
+        raise ValueError("%s has scene format %r, this runner reads %d"
+                         % (path, version, FORMAT_VERSION))
+    return data
+
+
+def build_equations(equations, count):
+    """MathTex mobjects for the first `count` equations. A repeat of an
+    earlier equation with the same LaTeX and style is a copy of it, so
+    Manim typesets and parses the SVG only once."""
+    from manim import MathTex
+
+    built = []
+    interned = {}
+    for eq in equations[:count]:
+        key = (eq["latex"], eq["color"], eq["scale"])
+        first = interned.get(key)
+        if first is not None:
+            mobject = built[first].copy()
+            mobject.move_to([eq["x"], eq["y"], 0])
+        else:
+            interned[key] = len(built)
+            mobject = MathTex(eq["latex"])
+            mobject.move_to([eq["x"], eq["y"], 0])
+            mobject.set_color(eq["color"])
+            mobject.scale(eq["scale"])
+        built.append(mobject)
+    return built
+
+
+def animate(scene, mobjects, equations, index):
+    from manim import TransformFromCopy, Write
+
+    eq = equations[index]
+    animation = eq.get("animation", "write")
+    if animation == "write":
+        scene.play(Write(mobjects[index]))
+    elif animation == "transform_from_copy":
+        scene.play(TransformFromCopy(mobjects[eq["from"]], mobjects[index]))
+    else:
+        raise ValueError("unknown animation %r for equation %d" % (animation, index))
+    if eq.get("wait"):
+        scene.wait(eq["wait"])
+
+
+def placeholder():
+    from manim import Text
+
+    return Text("No equations in scene", font_size=24)
+
+
+def construct_full(scene, data, spec):
+    equations = data["equations"]
+    if not equations:
+        from manim import Write
+
+        scene.play(Write(placeholder()))
+        scene.wait(1)
+        return
+    mobjects = build_equations(equations, len(equations))
+    # A range starts from the state at the end of the animation before it
+    first = spec.get("first", 0)
+    if first > 0:
+        scene.add(*mobjects[:first])
+    for index in range(first, len(equations)):
+        animate(scene, mobjects, equations, index)
+
+
+def construct_segment(scene, data, spec):
+    equations = data["equations"]
+    index = spec["index"]
+    mobjects = build_equations(equations, index + 1)
+    # State at the end of the previous segment
+    if index > 0:
+        scene.add(*mobjects[:index])
+    animate(scene, mobjects, equations, index)
+
+
+def construct_still(scene, data, spec):
+    equations = data["equations"]
+    if not equations:
+        scene.add(placeholder())
+        return
+    scene.add(*build_equations(equations, len(equations)))
+
+
+CONSTRUCTORS = {
+    "full": construct_full,
+    "segment": construct_segment,
+    "still": construct_still,
+}
+
+
+def scene_classes(data_path, module_name):
+    """Scene subclasses for every entry in the data file's "scenes",
+    belonging to `module_name` so Manim finds them there."""
+    from manim import Scene
+
+    data = load_scene_data(data_path)
+    classes = {}
+    for spec in data["scenes"]:
+        constructor = CONSTRUCTORS.get(spec["kind"])
+        if constructor is None:
+            raise ValueError("%s: unknown scene kind %r" % (data_path, spec["kind"]))
+
+        def construct(self, constructor=constructor, spec=spec):
+            constructor(self, data, spec)
+
+        classes[spec["name"]] = type(spec["name"], (Scene,),
+                                     {"construct": construct, "__module__": module_name})
+    return classes
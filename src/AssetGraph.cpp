@@ -0,0 +1,362 @@
+// src/AssetGraph.cpp
+#include "AssetGraph.hpp"
+#include "ManimScript.hpp"
+#include "RenderCache.hpp"
+#include "RenderEstimator.hpp"
+#include "Sha256.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+// Scene file names go into manifest ids, which must stay on one line
+std::string oneLine(std::string text) {
+    std::replace(text.begin(), text.end(), '\t', ' ');
+    std::replace(text.begin(), text.end(), '\n', ' ');
+    return text;
+}
+
+// A segment's input standing for every equation before its own
+const char* EARLIER = "earlier equations";
+
+// The first few changed inputs, then how many more
+std::string listChanges(const std::vector<std::string>& changed, size_t total) {
+    std::string reason;
+    for (size_t i = 0; i < changed.size() && i < 3; i++) reason += (i ? ", " : "") + changed[i];
+    if (total > 3) reason += " and " + std::to_string(total - 3) + " more";
+    return reason;
+}
+
+}
+
+void AssetManifest::setPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->path = path;
+    entries.clear();
+    loaded = false;
+    changed = false;
+}
+
+void AssetManifest::load() {
+    if (loaded) return;
+    loaded = true;
+
+    // A missing or unreadable file just means nothing is remembered yet
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields;
+        std::istringstream in(line);
+        std::string field;
+        while (std::getline(in, field, '\t')) fields.push_back(field);
+        if (fields.size() < 2 || fields.size() % 2 != 0) continue;
+
+        Entry entry;
+        entry.hash = fields[1];
+        for (size_t i = 2; i + 1 < fields.size(); i += 2) entry.inputs.emplace_back(fields[i], fields[i + 1]);
+        entry.sequence = next_sequence++;
+        entries[fields[0]] = std::move(entry);
+    }
+}
+
+bool AssetManifest::lookup(const std::string& id, Entry& entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    load();
+    auto it = entries.find(id);
+    if (it == entries.end()) return false;
+    entry = it->second;
+    return true;
+}
+
+void AssetManifest::update(const std::string& id, const std::string& hash, const Inputs& inputs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    load();
+    Entry& entry = entries[id];
+    entry.hash = hash;
+    entry.inputs = inputs;
+    entry.sequence = next_sequence++;
+    changed = true;
+}
+
+void AssetManifest::save() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!changed) return;
+    changed = false;
+
+    std::vector<std::pair<long, const std::string*>> order;
+    for (const auto& [id, entry] : entries) order.emplace_back(entry.sequence, &id);
+    std::sort(order.begin(), order.end());
+    size_t dropped = order.size() > MAX_ENTRIES ? order.size() - MAX_ENTRIES : 0;
+
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+
+    // Written aside and renamed, so a crash never leaves half a manifest
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::trunc);
+        for (size_t i = dropped; i < order.size(); i++) {
+            const Entry& entry = entries[*order[i].second];
+            file << *order[i].second << '\t' << entry.hash;
+            for (const auto& [name, hash] : entry.inputs) file << '\t' << name << '\t' << hash;
+            file << '\n';
+        }
+        if (!file) {
+            std::cerr << "[C++] Could not write " << temp << std::endl;
+            std::filesystem::remove(temp, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(temp, path, ec);
+    if (ec) {
+        std::cerr << "[C++] Could not replace " << path << ": " << ec.message() << std::endl;
+        return;
+    }
+    for (size_t i = 0; i < dropped; i++) entries.erase(*order[i].second);
+}
+
+AssetGraph::AssetGraph(const RenderOptions& options, const std::vector<MathEquation>& equations, bool segmented)
+    : first(options.first_animation) {
+    std::string scope = oneLine(options.filename) + " " + options.quality;
+
+    // One tex node per distinct snippet, numbered in first-use order
+    std::unordered_map<std::string, int> snippets;
+    for (const auto& eq : equations) {
+        auto [it, added] = snippets.emplace(eq.latex, static_cast<int>(nodes.size()));
+        if (added) {
+            Node node;
+            node.kind = Kind::Tex;
+            node.index = static_cast<int>(snippets.size()) - 1;
+            node.name = "tex " + std::to_string(node.index + 1);
+            node.hash = Sha256::hash(eq.latex);
+            node.id = texId(eq.latex);
+            node.latex = eq.latex;
+            nodes.push_back(std::move(node));
+        }
+        tex_of_equation.push_back(it->second);
+    }
+
+    // Equation i as every segment from i on sees it, and all of the
+    // equations before it chained into one hash, so a segment names two
+    // inputs however far into the scene it is
+    AssetManifest::Inputs equation_inputs;
+    std::vector<std::string> earlier(1, Sha256::hash(""));
+    for (size_t i = 0; i < equations.size(); i++) {
+        equation_inputs.emplace_back("equation " + std::to_string(i + 1),
+                                     Sha256::hash(ManimScript::equationData(equations[i], i)));
+        earlier.push_back(Sha256().update(earlier.back()).update(equation_inputs.back().second).hexDigest());
+    }
+
+    if (options.still_frame) {
+        Node node;
+        node.kind = Kind::Still;
+        node.name = "still";
+        node.id = "still " + scope;
+        node.hash = RenderCache::key(ManimScript::still(equations), options.quality);
+        node.inputs = equation_inputs;
+        node.typesets = static_cast<int>(equations.size());
+        node.output = Output::CacheOff;
+        nodes.push_back(std::move(node));
+        return;
+    }
+
+    Node video;
+    video.kind = Kind::Video;
+    video.name = "video";
+    // A range's video is a different asset from the whole scene's
+    video.id = "video " + scope + (first > 0 ? " from " + std::to_string(first) : "");
+    video.hash = RenderCache::key(ManimScript::scene(equations, first), options.quality);
+    video.inputs = equation_inputs;
+    // Rendered in segments, the segments typeset everything
+    video.typesets = segmented ? 0 : static_cast<int>(equations.size());
+
+    std::vector<std::string> segment_keys;
+    if (segmented) segment_keys = ManimScript::segmentKeys(equations, first, RenderCache::keyHasher(options.quality));
+    for (int i = first; segmented && i < static_cast<int>(equations.size()); i++) {
+        Node node;
+        node.kind = Kind::Segment;
+        node.index = i;
+        node.name = "segment " + std::to_string(i + 1);
+        node.id = "segment " + scope + " " + std::to_string(i);
+        node.hash = segment_keys[i - first];
+        if (i > 0) node.inputs.emplace_back(EARLIER, earlier[i]);
+        node.inputs.push_back(equation_inputs[i]);
+        node.typesets = i + 1;
+        if (first_segment < 0) first_segment = static_cast<int>(nodes.size());
+        nodes.push_back(std::move(node));
+    }
+    nodes.push_back(std::move(video));
+}
+
+std::string AssetGraph::texId(const std::string& latex) {
+    return "tex " + Sha256::hash(latex);
+}
+
+void AssetGraph::recordTex(AssetManifest& manifest, const std::string& latex, const std::string& svg) {
+    manifest.update(texId(latex), Sha256::hash(latex), {{"svg", svg}});
+}
+
+std::string AssetGraph::changes(const Node& node, AssetManifest& manifest, std::vector<std::string>& changed) {
+    AssetManifest::Entry previous;
+    if (!manifest.lookup(node.id, previous)) return "not built before";
+    if (previous.hash == node.hash) {
+        return node.kind == Kind::Segment ? "its clip is no longer in the segment cache"
+                                          : "its video is no longer in the render cache";
+    }
+
+    std::map<std::string, std::string> before(previous.inputs.begin(), previous.inputs.end());
+    for (const auto& [name, hash] : node.inputs) {
+        auto it = before.find(name);
+        if (it == before.end()) {
+            changed.push_back(name + " added");
+        } else {
+            if (it->second != hash) changed.push_back(name + " changed");
+            before.erase(it);
+        }
+    }
+    for (const auto& [name, hash] : before) changed.push_back(name + " removed");
+    // Same inputs, different hash: how they are turned into scene data
+    return changed.empty() ? "scene data format changed" : "";
+}
+
+void AssetGraph::decide(AssetManifest& manifest) {
+    // What changed for the segment before, carried forward so that later
+    // segments name the equations instead of "earlier equations changed"
+    std::vector<std::string> carried;
+    size_t carried_total = 0;
+    const Node* last_segment = nullptr;
+    int typeset = 0;
+
+    for (auto& node : nodes) {
+        if (node.kind == Kind::Tex) continue;
+        node.rebuild = node.output != Output::Present;
+        std::vector<std::string> changed;
+        size_t total = 0;
+        if (node.output == Output::Present) {
+            node.reason = "cached";
+        } else if (node.output == Output::CacheOff) {
+            node.reason = node.kind == Kind::Still ? "stills are not cached"
+                        : node.kind == Kind::Segment ? "the segment cache is off"
+                        : "the render cache is off";
+        } else {
+            node.reason = changes(node, manifest, changed);
+            total = changed.size();
+            std::string earlier = std::string(EARLIER) + " changed";
+            bool follows = node.kind == Kind::Segment && last_segment && last_segment->rebuild && carried_total > 0;
+            if (follows && !changed.empty() && changed.front() == earlier) {
+                changed.erase(changed.begin());
+                changed.insert(changed.begin(), carried.begin(), carried.end());
+                total += carried_total - 1;
+            }
+            if (node.reason.empty()) node.reason = listChanges(changed, total);
+        }
+        if (node.kind == Kind::Segment) {
+            if (changed.size() > 3) changed.resize(3);
+            carried = std::move(changed);
+            carried_total = total;
+            last_segment = &node;
+        }
+        if (node.rebuild) typeset = std::max(typeset, node.typesets);
+    }
+    for (int i = 0; i < typeset; i++) nodes[tex_of_equation[i]].needed = true;
+
+    // Manim keeps typeset snippets in its tex cache, shared by every scene
+    // and quality, as a file named after the whole TeX document. The
+    // manifest has the file each snippet went to when it was last typeset
+    // (see recordTex); it is up to date if that file is still there. A
+    // changed TeX template shows up once the snippet is typeset again.
+    for (auto& node : nodes) {
+        if (node.kind != Kind::Tex) continue;
+        if (node.output == Output::Untracked) {
+            // Manim still reuses its tex cache; we just can't tell what is in it
+            node.rebuild = false;
+            node.reason = node.needed ? "typeset by Manim unless in its tex cache (not tracked)"
+                                      : "not needed, everything using it is cached";
+            continue;
+        }
+        AssetManifest::Entry previous;
+        bool known = manifest.lookup(node.id, previous) && !previous.inputs.empty();
+        std::error_code ec;
+        node.output = known && std::filesystem::is_regular_file(previous.inputs.front().second, ec)
+                    ? Output::Present : Output::Missing;
+        node.rebuild = node.needed && node.output == Output::Missing;
+        node.reason = node.output == Output::Present ? "in Manim's tex cache"
+                    : !node.needed ? "not needed, everything using it is cached"
+                    : known ? "its SVG is no longer in Manim's tex cache"
+                    : "no typeset SVG on record";
+    }
+}
+
+void AssetGraph::record(AssetManifest& manifest) const {
+    // Tex nodes are recorded as they are typeset, with their file
+    for (const auto& node : nodes) {
+        if (node.kind == Kind::Still || node.kind == Kind::Tex) continue;
+        manifest.update(node.id, node.hash, node.inputs);
+    }
+}
+
+const AssetGraph::Node* AssetGraph::find(Kind kind, int index) const {
+    if (kind == Kind::Segment) {
+        int at = first_segment + index - first;
+        bool valid = first_segment >= 0 && index >= first && at < static_cast<int>(nodes.size()) &&
+                     nodes[at].kind == Kind::Segment;
+        return valid ? &nodes[at] : nullptr;
+    }
+    for (const auto& node : nodes) {
+        if (node.kind == kind && node.index == index) return &node;
+    }
+    return nullptr;
+}
+
+std::vector<std::string> AssetGraph::texSnippets(size_t count) const {
+    std::vector<std::string> snippets;
+    std::vector<bool> taken(nodes.size(), false);
+    for (size_t i = 0; i < count && i < tex_of_equation.size(); i++) {
+        int tex = tex_of_equation[i];
+        if (taken[tex]) continue;
+        taken[tex] = true;
+        snippets.push_back(nodes[tex].latex);
+    }
+    return snippets;
+}
+
+RenderWork AssetGraph::work(const std::vector<MathEquation>& equations) const {
+    RenderWork work;
+    if (find(Kind::Still)) {
+        for (const auto& eq : equations) work.tex_tokens += RenderEstimator::latexTokens(eq.latex);
+        return work;
+    }
+    const Node* video = find(Kind::Video);
+    if (video && !video->rebuild) {
+        work.cached = true;
+        return work;
+    }
+    if (equations.empty()) {
+        // The placeholder text's Write
+        work.animations = work.writes = 1;
+        return work;
+    }
+
+    bool segmented = find(Kind::Segment, first) != nullptr;
+    for (size_t i = first; i < equations.size(); i++) {
+        if (segmented && !find(Kind::Segment, static_cast<int>(i))->rebuild) continue;
+        work.animations++;
+        (i == 0 ? work.writes : work.transforms)++;
+        work.tex_tokens += RenderEstimator::latexTokens(equations[i].latex);
+    }
+    return work;
+}
+
+std::vector<AssetDecision> AssetGraph::decisions() const {
+    std::vector<AssetDecision> result;
+    for (const auto& node : nodes) {
+        result.push_back({node.name, node.hash, node.rebuild, node.reason});
+    }
+    return result;
+}
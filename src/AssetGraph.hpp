@@ -0,0 +1,133 @@
+// src/AssetGraph.hpp
+#ifndef ASSETGRAPH_HPP
+#define ASSETGRAPH_HPP
+
+#include "Equation.hpp"
+#include "RenderJob.hpp"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// What each asset was last built from, so a rebuild can name the input
+// that changed, across restarts too. A text file beside the caches with
+// one line per asset: id, hash, then each input's name and hash, tab
+// separated, least recently updated first.
+class AssetManifest {
+public:
+    using Inputs = std::vector<std::pair<std::string, std::string>>;
+
+    struct Entry {
+        std::string hash;
+        Inputs inputs;
+        long sequence = 0;  // when it was last updated
+    };
+
+private:
+    std::mutex mutex;
+    std::string path = "render_cache/assets.manifest";
+    std::map<std::string, Entry> entries;
+    long next_sequence = 0;
+    bool loaded = false;
+    bool changed = false;
+
+    // Caller holds `mutex`
+    void load();
+
+public:
+    // Assets remembered; the ones updated longest ago are dropped first
+    static constexpr size_t MAX_ENTRIES = 20000;
+
+    void setPath(const std::string& path);
+
+    bool lookup(const std::string& id, Entry& entry);
+    void update(const std::string& id, const std::string& hash, const Inputs& inputs);
+
+    // Write the file if anything was updated since it was last written
+    void save();
+};
+
+// The assets a render is built from, each named by a hash of everything
+// that goes into it:
+//
+//   tex N        a LaTeX snippet, typeset into Manim's tex cache
+//   segment N    animation N's clip, in the segment cache
+//   video        the scene's video, in the render cache
+//   still        a preview frame, never cached
+//
+// (N counted from 1, as on the timeline.) Segment N depends on the
+// snippets of equations 1..N; the video on its segments, or on the
+// snippets directly when it is rendered whole. A segment's inputs are its
+// own equation and one chained hash of the equations before it, so the
+// graph stays linear in the length of the scene. As a node's hash covers all
+// of its inputs, it is up to date exactly when its output for that hash
+// exists, whatever happened to what it depends on: only the nodes that
+// aren't, and the snippets those use, are rebuilt. The manifest tells what
+// a rebuilt node was made from last time, which is the reason given.
+class AssetGraph {
+public:
+    enum class Kind { Tex, Segment, Video, Still };
+
+    // Whether a node's output exists; filled in by the owner of the caches
+    // for everything but tex, which decide() checks in Manim's tex cache
+    // unless the owner marks it Untracked (nothing records where it went)
+    enum class Output { Missing, Present, CacheOff, Untracked };
+
+    struct Node {
+        Kind kind = Kind::Tex;
+        int index = 0;                 // snippet, or the segment's animation (from 0)
+        std::string name;              // "tex 2", "segment 3", "video", "still"
+        std::string id;                // in the manifest: per scene file and quality, except tex
+        std::string hash;
+        AssetManifest::Inputs inputs;  // what the hash covers, for the reason
+        std::string latex;             // of a tex node
+        int typesets = 0;              // rendering it typesets equations 0..typesets-1
+        Output output = Output::Missing;
+        bool needed = false;           // a tex node something rebuilt uses
+        bool rebuild = false;
+        std::string reason;
+    };
+
+    std::vector<Node> nodes;
+
+private:
+    int first = 0;                     // animation the render starts at
+    std::vector<int> tex_of_equation;  // tex node of each equation
+    int first_segment = -1;            // node of segment `first`; the rest follow it
+
+    // Why `node`, whose output is missing, differs from its last build:
+    // the reason, or "" with the inputs that changed in `changed`
+    static std::string changes(const Node& node, AssetManifest& manifest, std::vector<std::string>& changed);
+
+    static std::string texId(const std::string& latex);
+
+public:
+    // The nodes for rendering `equations`, already cut to the range, with
+    // `options`, as segments or as one video; nothing decided yet
+    AssetGraph(const RenderOptions& options, const std::vector<MathEquation>& equations, bool segmented);
+
+    // Decide what to rebuild from the nodes' outputs and the manifest
+    void decide(AssetManifest& manifest);
+
+    // Remember what the nodes were built from, once the render succeeded
+    void record(AssetManifest& manifest) const;
+
+    // Remember the file in Manim's tex cache `latex` was typeset to
+    static void recordTex(AssetManifest& manifest, const std::string& latex, const std::string& svg);
+
+    // The node of `kind` for `index` (the animation of a segment), or nullptr
+    const Node* find(Kind kind, int index = 0) const;
+
+    // Distinct LaTeX of the first `count` equations: what rendering up to
+    // animation count-1 typesets, cached or not
+    std::vector<std::string> texSnippets(size_t count) const;
+
+    // What is left to render, for RenderEstimator
+    RenderWork work(const std::vector<MathEquation>& equations) const;
+
+    std::vector<AssetDecision> decisions() const;
+};
+
+#endif
@@ -0,0 +1,251 @@
+// src/ChildProcess.cpp
+#include "ChildProcess.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+
+void closePipe(int fds[2]) {
+    if (fds[0] >= 0) close(fds[0]);
+    if (fds[1] >= 0) close(fds[1]);
+}
+
+}
+
+ChildProcess spawnProcessGroup(const std::vector<std::string>& argv, bool with_stdin) {
+    if (argv.empty()) throw std::runtime_error("Nothing to run");
+
+    // O_CLOEXEC so concurrent jobs' children don't inherit each other's
+    // write ends and hold the pipe open past their own Manim's exit; the
+    // dup2 actions below clear it on the child's 0/1/2
+    int out_fds[2] = {-1, -1};
+    int err_fds[2] = {-1, -1};
+    int in_fds[2] = {-1, -1};
+    if (pipe2(out_fds, O_CLOEXEC) != 0 || pipe2(err_fds, O_CLOEXEC) != 0 ||
+        (with_stdin && pipe2(in_fds, O_CLOEXEC) != 0)) {
+        closePipe(out_fds);
+        closePipe(err_fds);
+        closePipe(in_fds);
+        throw std::runtime_error("Could not create pipes for " + argv[0]);
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, out_fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, err_fds[1], STDERR_FILENO);
+    // Without a stdin pipe the child reads /dev/null rather than our
+    // terminal, so a LaTeX error prompt gets EOF and exits instead of
+    // waiting for input forever
+    if (with_stdin) posix_spawn_file_actions_adddup2(&actions, in_fds[0], STDIN_FILENO);
+    else posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+
+    // Group 0 makes the child the leader of a new group before it execs,
+    // so a cancel racing the spawn already sees the group
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF);
+    posix_spawnattr_setpgroup(&attributes, 0);
+    // The app ignores SIGPIPE for its worker pipes; children get the default
+    sigset_t default_signals;
+    sigemptyset(&default_signals);
+    sigaddset(&default_signals, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attributes, &default_signals);
+
+    std::vector<char*> args;
+    for (const auto& arg : argv) args.push_back(const_cast<char*>(arg.c_str()));
+    args.push_back(nullptr);
+
+    pid_t pid;
+    int error = posix_spawnp(&pid, args[0], &actions, &attributes, args.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attributes);
+
+    close(out_fds[1]);
+    close(err_fds[1]);
+    if (with_stdin) close(in_fds[0]);
+    if (error != 0) {
+        close(out_fds[0]);
+        close(err_fds[0]);
+        if (with_stdin) close(in_fds[1]);
+        throw std::runtime_error("Failed to start " + argv[0] + ": " + std::strerror(error));
+    }
+
+    ChildProcess child;
+    child.pid = pid;
+    child.out_fd = out_fds[0];
+    child.err_fd = err_fds[0];
+    child.in_fd = with_stdin ? in_fds[1] : -1;
+    return child;
+}
+
+int waitProcess(ChildProcess& child, ProcessUsage* usage) {
+    for (int* fd : {&child.out_fd, &child.err_fd, &child.in_fd}) {
+        if (*fd >= 0) close(*fd);
+        *fd = -1;
+    }
+
+    int status = 0;
+    if (child.pid > 0) {
+        rusage resources{};
+        while (wait4(child.pid, &status, 0, &resources) < 0 && errno == EINTR) {}
+        if (usage) {
+            usage->user_seconds = resources.ru_utime.tv_sec + resources.ru_utime.tv_usec / 1e6;
+            usage->system_seconds = resources.ru_stime.tv_sec + resources.ru_stime.tv_usec / 1e6;
+            usage->max_rss_kb = resources.ru_maxrss;
+        }
+    }
+    child.pid = -1;
+    return status;
+}
+
+void signalProcessGroup(const ChildProcess& child, int signal_number) {
+    if (child.pid > 0) kill(-child.pid, signal_number);
+}
+
+std::map<pid_t, ProcessSample> sampleProcessGroups(const std::set<pid_t>& groups) {
+    std::map<pid_t, ProcessSample> samples;
+    if (groups.empty()) return samples;
+
+    static const long ticks_per_second = sysconf(_SC_CLK_TCK);
+    static const long page_kb = sysconf(_SC_PAGESIZE) / 1024;
+
+    DIR* proc = opendir("/proc");
+    if (!proc) return samples;
+    while (dirent* entry = readdir(proc)) {
+        if (entry->d_name[0] < '1' || entry->d_name[0] > '9') continue;
+        std::string dir = std::string("/proc/") + entry->d_name;
+
+        // The command name is in parentheses and may contain spaces, so
+        // the fields are counted from the last ')'
+        std::ifstream stat_file(dir + "/stat");
+        std::string stat;
+        if (!std::getline(stat_file, stat)) continue;
+        size_t name_end = stat.rfind(')');
+        if (name_end == std::string::npos) continue;
+        std::istringstream fields(stat.substr(name_end + 2));
+        std::string state;
+        long ppid, pgrp, session, tty, tpgid;
+        unsigned long flags, minflt, cminflt, majflt, cmajflt, utime, stime;
+        long cutime, cstime, priority, nice, threads, itrealvalue;
+        unsigned long long starttime;
+        unsigned long vsize;
+        long rss;
+        if (!(fields >> state >> ppid >> pgrp >> session >> tty >> tpgid >> flags >> minflt >> cminflt
+                     >> majflt >> cmajflt >> utime >> stime >> cutime >> cstime >> priority >> nice
+                     >> threads >> itrealvalue >> starttime >> vsize >> rss)) {
+            continue;
+        }
+        if (!groups.count(static_cast<pid_t>(pgrp)) || state == "Z") continue;
+
+        ProcessSample& sample = samples[static_cast<pid_t>(pgrp)];
+        sample.processes++;
+        sample.cpu_seconds += static_cast<double>(utime + stime) / ticks_per_second;
+        sample.rss_kb += rss * page_kb;
+
+        std::ifstream io(dir + "/io");
+        std::string key;
+        uint64_t value;
+        while (io >> key >> value) {
+            if (key == "read_bytes:") sample.read_bytes += value;
+            else if (key == "write_bytes:") sample.write_bytes += value;
+        }
+    }
+    closedir(proc);
+    return samples;
+}
+
+size_t readFully(int fd, void* data, size_t length) {
+    unsigned char* bytes = static_cast<unsigned char*>(data);
+    size_t filled = 0;
+    while (filled < length) {
+        ssize_t n = read(fd, bytes + filled, length - filled);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        filled += static_cast<size_t>(n);
+    }
+    return filled;
+}
+
+void drainReadable(int fd, OutputRing* sink) {
+    std::array<char, 4096> buffer;
+    pollfd pfd{fd, POLLIN, 0};
+    while (fd >= 0 && poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN)) {
+        ssize_t n = read(fd, buffer.data(), buffer.size());
+        if (n <= 0) break;
+        if (sink) sink->append(buffer.data(), static_cast<size_t>(n));
+    }
+}
+
+ProcessResult runProcess(const std::vector<std::string>& argv, size_t output_limit) {
+    ProcessResult result;
+    result.output = OutputRing(output_limit);
+    ChildProcess child = spawnProcessGroup(argv);
+
+    // Both pipes must be read as data arrives, or a chatty child blocks
+    // on whichever one fills up first
+    std::array<char, 4096> buffer;
+    pollfd fds[2] = {{child.out_fd, POLLIN, 0}, {child.err_fd, POLLIN, 0}};
+    int open_streams = 2;
+    while (open_streams > 0) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (auto& pfd : fds) {
+            if (pfd.fd < 0 || !(pfd.revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t n = read(pfd.fd, buffer.data(), buffer.size());
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                pfd.fd = -1;
+                open_streams--;
+                continue;
+            }
+            result.output.append(buffer.data(), static_cast<size_t>(n));
+        }
+    }
+
+    result.status = waitProcess(child, &result.usage);
+    return result;
+}
+
+bool ProcessResult::succeeded() const {
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+std::string ProcessResult::describe() const {
+    char text[160];
+    if (WIFSIGNALED(status)) {
+        snprintf(text, sizeof(text), "killed by signal %d", WTERMSIG(status));
+    } else {
+        snprintf(text, sizeof(text), "exit %d", WEXITSTATUS(status));
+    }
+    char resources[120];
+    snprintf(resources, sizeof(resources), ", %.1fs user, %.1fs sys, %ld MB max RSS",
+             usage.user_seconds, usage.system_seconds, usage.max_rss_kb / 1024);
+    return std::string(text) + resources;
+}
+
+std::string commandLine(const std::vector<std::string>& argv) {
+    std::string line;
+    for (const auto& arg : argv) {
+        if (!line.empty()) line += ' ';
+        bool plain = !arg.empty() && arg.find_first_of(" \t\n'\"\\$") == std::string::npos;
+        line += plain ? arg : "'" + arg + "'";
+    }
+    return line;
+}
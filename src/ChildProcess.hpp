@@ -0,0 +1,81 @@
+// src/ChildProcess.hpp
+#ifndef CHILDPROCESS_HPP
+#define CHILDPROCESS_HPP
+
+#include "OutputRing.hpp"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+// A program running in its own process group, with its stdout and stderr
+// on separate pipes; `in_fd` is the write end of its stdin when requested.
+struct ChildProcess {
+    pid_t pid = -1;   // also the process group id
+    int out_fd = -1;
+    int err_fd = -1;
+    int in_fd = -1;
+
+    bool running() const { return pid > 0; }
+};
+
+// Resources a reaped child (and its reaped descendants) used
+struct ProcessUsage {
+    double user_seconds = 0.0;
+    double system_seconds = 0.0;
+    long max_rss_kb = 0;
+};
+
+// What a process group's live members are using right now, from /proc.
+// Members that have already exited are not counted.
+struct ProcessSample {
+    int processes = 0;
+    double cpu_seconds = 0.0;   // user + system
+    long rss_kb = 0;
+    uint64_t read_bytes = 0;    // storage I/O, where /proc/<pid>/io is readable
+    uint64_t write_bytes = 0;
+};
+
+// Outcome of runProcess
+struct ProcessResult {
+    int status = 0;         // waitpid status
+    ProcessUsage usage;
+    OutputRing output;      // stdout and stderr, in arrival order
+
+    bool succeeded() const;
+    std::string describe() const;  // "exit 0, 1.2s user, 0.1s sys, 80 MB max RSS"
+};
+
+// Start argv[0] (looked up in PATH) with posix_spawn, no shell involved,
+// in a new process group. Manim forks latex, dvisvgm and ffmpeg; keeping
+// them all in one group lets a cancel reach the whole tree with
+// kill(-pgid). Throws std::runtime_error on failure.
+ChildProcess spawnProcessGroup(const std::vector<std::string>& argv, bool with_stdin = false);
+
+// Close our pipe ends and reap the process; returns the waitpid status
+int waitProcess(ChildProcess& child, ProcessUsage* usage = nullptr);
+
+// Signal every process in the child's group
+void signalProcessGroup(const ChildProcess& child, int signal_number);
+
+// One pass over /proc: the live members of each of `groups`, summed per
+// group. Manim's latex, dvisvgm and ffmpeg children stay in the group
+// they were spawned in, so this covers the whole render tree.
+std::map<pid_t, ProcessSample> sampleProcessGroups(const std::set<pid_t>& groups);
+
+// Run argv to completion, keeping the last `output_limit` bytes it prints
+ProcessResult runProcess(const std::vector<std::string>& argv, size_t output_limit = 64 * 1024);
+
+// Read until `length` bytes arrived or the pipe closed; returns the count
+size_t readFully(int fd, void* data, size_t length);
+
+// Read whatever is already waiting on `fd` without blocking
+void drainReadable(int fd, OutputRing* sink = nullptr);
+
+// "python -m manim a.py" style rendering of argv for log messages
+std::string commandLine(const std::vector<std::string>& argv);
+
+#endif
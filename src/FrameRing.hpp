@@ -0,0 +1,81 @@
+// src/FrameRing.hpp
+#ifndef FRAMERING_HPP
+#define FRAMERING_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+// One decoded RGB frame and its index in the video
+struct VideoFrame {
+    int index = -1;
+    std::vector<unsigned char> rgb;
+};
+
+// Fixed-size queue of decoded frames between a decoder thread and the
+// Tcl thread. The decoder blocks while it is full, so prefetching never
+// runs more than `capacity` frames ahead. Frames are swapped in and out
+// rather than copied, so the pixel buffers are allocated once and then
+// reused.
+class FrameRing {
+private:
+    std::mutex mutex;
+    std::condition_variable space;
+    std::vector<VideoFrame> slots;
+    size_t head = 0;    // oldest frame
+    size_t count = 0;
+    bool closed = false;
+
+public:
+    explicit FrameRing(size_t capacity = 1) : slots(capacity ? capacity : 1) {}
+
+    // Empty ring holding `capacity` frames; call with no decoder running
+    void reset(size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex);
+        slots.assign(capacity ? capacity : 1, VideoFrame());
+        head = 0;
+        count = 0;
+        closed = false;
+    }
+
+    // Wait for room and take `frame`, leaving it with a spare buffer.
+    // False once the ring is closed.
+    bool push(VideoFrame& frame) {
+        std::unique_lock<std::mutex> lock(mutex);
+        space.wait(lock, [this] { return closed || count < slots.size(); });
+        if (closed) return false;
+        std::swap(slots[(head + count) % slots.size()], frame);
+        count++;
+        return true;
+    }
+
+    // Oldest frame into `frame` without waiting; false if none is ready
+    bool pop(VideoFrame& frame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (count == 0) return false;
+        std::swap(slots[head], frame);
+        head = (head + 1) % slots.size();
+        count--;
+        space.notify_one();
+        return true;
+    }
+
+    // Wake a decoder blocked in push() and refuse further frames
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        space.notify_all();
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return count;
+    }
+
+    size_t capacity() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return slots.size();
+    }
+};
+
+#endif
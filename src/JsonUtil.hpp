@@ -0,0 +1,88 @@
+// src/JsonUtil.hpp
+#ifndef JSONUTIL_HPP
+#define JSONUTIL_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Just enough JSON for the flat objects exchanged with the Python helpers
+
+inline std::string jsonQuote(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+// Parse the string literal starting at json[pos] (the opening quote);
+// leaves pos just past the closing quote
+inline std::string jsonParseString(const std::string& json, size_t& pos) {
+    std::string value;
+    for (pos++; pos < json.size() && json[pos] != '"'; pos++) {
+        if (json[pos] == '\\' && pos + 1 < json.size()) {
+            char e = json[++pos];
+            value += e == 'n' ? '\n' : e == 't' ? '\t' : e == 'r' ? '\r' : e;
+        } else {
+            value += json[pos];
+        }
+    }
+    if (pos < json.size()) pos++;
+    return value;
+}
+
+// Position of the value for `key`, or npos
+inline size_t jsonValuePos(const std::string& json, const std::string& key) {
+    size_t pos = json.find("\"" + key + "\"");
+    if (pos == std::string::npos) return pos;
+    pos = json.find(':', pos);
+    if (pos == std::string::npos) return pos;
+    return json.find_first_not_of(" \t\r\n", pos + 1);
+}
+
+// Value of `key`: the unescaped text of a string, or the literal
+// (true/false/number) as written
+inline std::string jsonField(const std::string& json, const std::string& key) {
+    size_t pos = jsonValuePos(json, key);
+    if (pos == std::string::npos) return "";
+
+    if (json[pos] == '"') return jsonParseString(json, pos);
+
+    size_t end = json.find_first_of(",}]", pos);
+    std::string value = json.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    value.erase(value.find_last_not_of(" \t\r\n") + 1);
+    return value;
+}
+
+// Elements of a string array value for `key`
+inline std::vector<std::string> jsonStringArray(const std::string& json, const std::string& key) {
+    std::vector<std::string> values;
+    size_t pos = jsonValuePos(json, key);
+    if (pos == std::string::npos || json[pos] != '[') return values;
+
+    for (pos++; pos < json.size() && json[pos] != ']'; ) {
+        if (json[pos] == '"') {
+            values.push_back(jsonParseString(json, pos));
+        } else {
+            pos++;
+        }
+    }
+    return values;
+}
+
+#endif
@@ -0,0 +1,437 @@
+// src/LatexValidator.cpp
+#include "LatexValidator.hpp"
+
+#include <cctype>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// Math mode macros and how many mandatory arguments they take
+const std::unordered_map<std::string, int>& knownMacros() {
+    static const std::unordered_map<std::string, int> macros = {
+        // Fractions, roots and stacking
+        {"frac", 2}, {"dfrac", 2}, {"tfrac", 2}, {"cfrac", 2},
+        {"binom", 2}, {"dbinom", 2}, {"tbinom", 2},
+        {"sqrt", 1}, {"stackrel", 2}, {"overset", 2}, {"underset", 2},
+        {"substack", 1}, {"xrightarrow", 1}, {"xleftarrow", 1},
+
+        // Accents and decorations
+        {"hat", 1}, {"widehat", 1}, {"bar", 1}, {"overline", 1}, {"underline", 1},
+        {"vec", 1}, {"dot", 1}, {"ddot", 1}, {"dddot", 1}, {"tilde", 1}, {"widetilde", 1},
+        {"acute", 1}, {"grave", 1}, {"check", 1}, {"breve", 1}, {"mathring", 1},
+        {"overbrace", 1}, {"underbrace", 1}, {"overrightarrow", 1}, {"overleftarrow", 1},
+        {"boxed", 1}, {"cancel", 1}, {"phantom", 1}, {"hphantom", 1}, {"vphantom", 1},
+
+        // Fonts, text and color
+        {"mathbf", 1}, {"mathrm", 1}, {"mathit", 1}, {"mathsf", 1}, {"mathtt", 1},
+        {"mathcal", 1}, {"mathbb", 1}, {"mathfrak", 1}, {"mathscr", 1}, {"boldsymbol", 1},
+        {"text", 1}, {"textbf", 1}, {"textit", 1}, {"textrm", 1}, {"mbox", 1},
+        {"operatorname", 1}, {"color", 1}, {"textcolor", 2},
+        {"bf", 0}, {"rm", 0}, {"it", 0}, {"cal", 0},
+        {"displaystyle", 0}, {"textstyle", 0}, {"scriptstyle", 0}, {"scriptscriptstyle", 0},
+
+        // Delimiters
+        {"left", 0}, {"right", 0}, {"middle", 0},
+        {"big", 0}, {"Big", 0}, {"bigg", 0}, {"Bigg", 0},
+        {"bigl", 0}, {"bigr", 0}, {"Bigl", 0}, {"Bigr", 0},
+        {"biggl", 0}, {"biggr", 0}, {"Biggl", 0}, {"Biggr", 0},
+        {"langle", 0}, {"rangle", 0}, {"lfloor", 0}, {"rfloor", 0}, {"lceil", 0}, {"rceil", 0},
+        {"lvert", 0}, {"rvert", 0}, {"lVert", 0}, {"rVert", 0}, {"vert", 0}, {"Vert", 0},
+        {"lbrace", 0}, {"rbrace", 0}, {"lbrack", 0}, {"rbrack", 0},
+
+        // Greek
+        {"alpha", 0}, {"beta", 0}, {"gamma", 0}, {"delta", 0}, {"epsilon", 0},
+        {"varepsilon", 0}, {"zeta", 0}, {"eta", 0}, {"theta", 0}, {"vartheta", 0},
+        {"iota", 0}, {"kappa", 0}, {"lambda", 0}, {"mu", 0}, {"nu", 0}, {"xi", 0},
+        {"pi", 0}, {"varpi", 0}, {"rho", 0}, {"varrho", 0}, {"sigma", 0}, {"varsigma", 0},
+        {"tau", 0}, {"upsilon", 0}, {"phi", 0}, {"varphi", 0}, {"chi", 0}, {"psi", 0},
+        {"omega", 0}, {"Gamma", 0}, {"Delta", 0}, {"Theta", 0}, {"Lambda", 0}, {"Xi", 0},
+        {"Pi", 0}, {"Sigma", 0}, {"Upsilon", 0}, {"Phi", 0}, {"Psi", 0}, {"Omega", 0},
+
+        // Big operators and functions
+        {"sum", 0}, {"prod", 0}, {"coprod", 0}, {"int", 0}, {"iint", 0}, {"iiint", 0},
+        {"oint", 0}, {"bigcup", 0}, {"bigcap", 0}, {"bigoplus", 0}, {"bigotimes", 0},
+        {"lim", 0}, {"limsup", 0}, {"liminf", 0}, {"sup", 0}, {"inf", 0}, {"max", 0},
+        {"min", 0}, {"arg", 0}, {"det", 0}, {"dim", 0}, {"gcd", 0}, {"deg", 0}, {"ker", 0},
+        {"sin", 0}, {"cos", 0}, {"tan", 0}, {"cot", 0}, {"sec", 0}, {"csc", 0},
+        {"arcsin", 0}, {"arccos", 0}, {"arctan", 0}, {"sinh", 0}, {"cosh", 0}, {"tanh", 0},
+        {"exp", 0}, {"log", 0}, {"ln", 0}, {"lg", 0}, {"Pr", 0}, {"limits", 0}, {"nolimits", 0},
+
+        // Relations, arrows and binary operators
+        {"leq", 0}, {"geq", 0}, {"le", 0}, {"ge", 0}, {"neq", 0}, {"ne", 0}, {"approx", 0},
+        {"equiv", 0}, {"sim", 0}, {"simeq", 0}, {"cong", 0}, {"propto", 0}, {"ll", 0},
+        {"gg", 0}, {"in", 0}, {"notin", 0}, {"ni", 0}, {"subset", 0}, {"supset", 0},
+        {"subseteq", 0}, {"supseteq", 0}, {"mid", 0}, {"parallel", 0}, {"perp", 0},
+        {"to", 0}, {"gets", 0}, {"mapsto", 0}, {"rightarrow", 0}, {"leftarrow", 0},
+        {"Rightarrow", 0}, {"Leftarrow", 0}, {"leftrightarrow", 0}, {"Leftrightarrow", 0},
+        {"implies", 0}, {"impliedby", 0}, {"iff", 0}, {"uparrow", 0}, {"downarrow", 0},
+        {"longrightarrow", 0}, {"longleftarrow", 0}, {"Longrightarrow", 0}, {"longmapsto", 0},
+        {"pm", 0}, {"mp", 0}, {"times", 0}, {"div", 0}, {"cdot", 0}, {"ast", 0}, {"star", 0},
+        {"circ", 0}, {"bullet", 0}, {"oplus", 0}, {"otimes", 0}, {"cup", 0}, {"cap", 0},
+        {"setminus", 0}, {"wedge", 0}, {"vee", 0}, {"land", 0}, {"lor", 0}, {"neg", 0}, {"lnot", 0},
+
+        // Symbols
+        {"infty", 0}, {"partial", 0}, {"nabla", 0}, {"forall", 0}, {"exists", 0},
+        {"nexists", 0}, {"emptyset", 0}, {"varnothing", 0}, {"prime", 0}, {"hbar", 0},
+        {"ell", 0}, {"Re", 0}, {"Im", 0}, {"aleph", 0}, {"angle", 0}, {"triangle", 0},
+        {"degree", 0}, {"checkmark", 0}, {"therefore", 0}, {"because", 0},
+        {"ldots", 0}, {"cdots", 0}, {"vdots", 0}, {"ddots", 0}, {"dots", 0},
+        {"N", 0}, {"Z", 0}, {"Q", 0}, {"R", 0}, {"C", 0},
+
+        // Spacing and layout
+        {"quad", 0}, {"qquad", 0}, {"hspace", 1}, {"vspace", 1}, {"hfill", 0},
+        {"nonumber", 0}, {"notag", 0}, {"tag", 1}, {"label", 1}, {"intertext", 1},
+        {"newline", 0}, {"not", 0}, {"over", 0}, {"choose", 0}, {"atop", 0},
+        {"begin", 1}, {"end", 1},
+    };
+    return macros;
+}
+
+// Macros that take a [...] optional argument before the mandatory ones
+const std::unordered_set<std::string>& optionalArgumentMacros() {
+    static const std::unordered_set<std::string> macros = {
+        "sqrt", "xrightarrow", "xleftarrow", "cfrac",
+    };
+    return macros;
+}
+
+// Macros whose argument is typeset in text mode
+const std::unordered_set<std::string>& textMacros() {
+    static const std::unordered_set<std::string> macros = {
+        "text", "textbf", "textit", "textrm", "mbox", "intertext",
+    };
+    return macros;
+}
+
+// Environments that work inside align*
+const std::unordered_set<std::string>& knownEnvironments() {
+    static const std::unordered_set<std::string> environments = {
+        "aligned", "alignedat", "gathered", "split", "cases", "dcases", "rcases",
+        "matrix", "pmatrix", "bmatrix", "Bmatrix", "vmatrix", "Vmatrix", "smallmatrix",
+        "array", "subarray",
+    };
+    return environments;
+}
+
+class Checker {
+private:
+    struct Frame {
+        enum Kind { Brace, Environment, Left } kind;
+        size_t pos;
+        std::string name;
+    };
+
+    const std::string& text;
+    std::vector<Frame> stack;
+    std::vector<LatexIssue> issues;
+
+    size_t column(size_t pos) const {
+        // Count characters, not bytes, so UTF-8 input lines up in the GUI
+        size_t chars = 0;
+        for (size_t i = 0; i < pos && i < text.size(); i++) {
+            if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80) chars++;
+        }
+        return chars + 1;
+    }
+
+    void report(LatexIssue::Severity severity, size_t pos, const std::string& message) {
+        issues.push_back({severity, column(pos), message});
+    }
+
+    size_t skipSpaces(size_t pos) const {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+        return pos;
+    }
+
+    // Name of the control sequence whose backslash is at `pos`; `end` is
+    // set just past it
+    std::string macroName(size_t pos, size_t& end) const {
+        end = pos + 1;
+        if (end >= text.size()) return "";
+        if (!std::isalpha(static_cast<unsigned char>(text[end]))) {
+            return std::string(1, text[end++]);  // control symbol like \, or \{
+        }
+        while (end < text.size() && std::isalpha(static_cast<unsigned char>(text[end]))) end++;
+        return text.substr(pos + 1, end - pos - 1);
+    }
+
+    // Past the group opened by `open` at `pos`, or npos if it never closes.
+    // Nesting problems inside are reported by the main scan.
+    size_t skipGroup(size_t pos, char open, char close) const {
+        int depth = 0;
+        for (size_t i = pos; i < text.size(); i++) {
+            if (text[i] == '\\') {
+                i++;
+            } else if (text[i] == open) {
+                depth++;
+            } else if (text[i] == close && --depth == 0) {
+                return i + 1;
+            }
+        }
+        return std::string::npos;
+    }
+
+    // Past one macro or script argument starting at or after `pos`, or
+    // npos if there is none before the group, cell or input ends
+    size_t skipArgument(size_t pos) const {
+        pos = skipSpaces(pos);
+        if (pos >= text.size()) return std::string::npos;
+        char c = text[pos];
+        if (c == '}' || c == '&' || c == '^' || c == '_') return std::string::npos;
+        if (c == '{') {
+            size_t end = skipGroup(pos, '{', '}');
+            return end == std::string::npos ? text.size() : end;
+        }
+        if (c == '\\') {
+            size_t end;
+            std::string name = macroName(pos, end);
+            if (name == "\\" || name == "end" || name == "right") return std::string::npos;
+            return end;
+        }
+        // One character; step over the rest of a UTF-8 sequence
+        pos++;
+        while (pos < text.size() && (static_cast<unsigned char>(text[pos]) & 0xC0) == 0x80) pos++;
+        return pos;
+    }
+
+    // Environment name in the {...} after \begin or \end at `pos`
+    std::string environmentName(size_t pos, size_t& end) const {
+        size_t open = skipSpaces(pos);
+        end = open;
+        if (open >= text.size() || text[open] != '{') return "";
+        size_t close = text.find('}', open);
+        if (close == std::string::npos) return "";
+        end = close + 1;
+        return text.substr(open + 1, close - open - 1);
+    }
+
+    void checkScripts(size_t pos) {
+        // A second ^ (or _) on the same atom, possibly after the other kind
+        char script = text[pos];
+        size_t end = skipArgument(pos + 1);
+        if (end == std::string::npos) {
+            if (skipSpaces(pos + 1) < text.size() || !stack.empty()) {
+                report(LatexIssue::Error, pos, std::string("Missing argument for ") + script);
+            }
+            return;
+        }
+        size_t next = skipSpaces(end);
+        char other = script == '^' ? '_' : '^';
+        if (next < text.size() && text[next] == other) {
+            size_t after = skipArgument(next + 1);
+            if (after == std::string::npos) return;
+            next = skipSpaces(after);
+        }
+        if (next < text.size() && text[next] == script) {
+            report(LatexIssue::Error, next, script == '^' ? "Double superscript" : "Double subscript");
+        }
+    }
+
+    void checkMacro(size_t pos, const std::string& name, size_t end) {
+        auto known = knownMacros().find(name);
+        if (known == knownMacros().end()) {
+            report(LatexIssue::Warning, pos, "Unknown macro \\" + name);
+            return;
+        }
+
+        int expected = known->second;
+        size_t arg = end;
+        if (optionalArgumentMacros().count(name)) {
+            size_t bracket = skipSpaces(arg);
+            if (bracket < text.size() && text[bracket] == '[') {
+                arg = skipGroup(bracket, '[', ']');
+                if (arg == std::string::npos) {
+                    report(LatexIssue::Error, bracket, "Unclosed [ in \\" + name);
+                    return;
+                }
+            }
+        }
+        for (int found = 0; found < expected; found++) {
+            arg = skipArgument(arg);
+            if (arg == std::string::npos) {
+                report(LatexIssue::Error, pos, "\\" + name + " expects " + std::to_string(expected) +
+                       (expected == 1 ? " argument" : " arguments") + ", found " + std::to_string(found));
+                return;
+            }
+        }
+    }
+
+    void checkDelimiter(size_t pos, const std::string& name, size_t end) {
+        size_t delim = skipSpaces(end);
+        if (delim >= text.size() || text[delim] == '}' || text[delim] == '{') {
+            report(LatexIssue::Error, pos, "Missing delimiter after \\" + name);
+        }
+    }
+
+    void closeBrace(size_t pos) {
+        if (stack.empty()) {
+            report(LatexIssue::Error, pos, "Unmatched }");
+            return;
+        }
+        const Frame& top = stack.back();
+        if (top.kind == Frame::Brace) {
+            stack.pop_back();
+            return;
+        }
+        // The group ends inside an environment or \left...\right; TeX
+        // complains about the inner construct, so point at that
+        report(LatexIssue::Error, top.pos, top.kind == Frame::Left
+               ? "\\left is not closed before the } at column " + std::to_string(column(pos))
+               : "\\begin{" + top.name + "} is not ended before the } at column " + std::to_string(column(pos)));
+        stack.pop_back();
+        if (!stack.empty() && stack.back().kind == Frame::Brace) stack.pop_back();
+    }
+
+    // Handle the control sequence at `pos`; returns the position after it
+    size_t scanMacro(size_t pos) {
+        size_t end;
+        std::string name = macroName(pos, end);
+        if (name.empty()) {
+            report(LatexIssue::Error, pos, "Stray \\ at end of equation");
+            return end;
+        }
+        if (name.size() == 1 && !std::isalpha(static_cast<unsigned char>(name[0]))) {
+            return end;  // \, \; \! \\ \{ \} \| \% and friends
+        }
+
+        if (name == "begin" || name == "end") {
+            size_t name_end;
+            std::string env = environmentName(end, name_end);
+            if (env.empty()) {
+                report(LatexIssue::Error, pos, "\\" + name + " needs an environment name in braces");
+                return end;
+            }
+            if (name == "begin") {
+                if (!knownEnvironments().count(env)) {
+                    report(LatexIssue::Warning, pos, "Unknown environment " + env);
+                }
+                stack.push_back({Frame::Environment, pos, env});
+                if (env == "array" || env == "subarray" || env == "alignedat") {
+                    if (skipArgument(name_end) == std::string::npos) {
+                        report(LatexIssue::Error, pos, "\\begin{" + env + "} expects a column argument");
+                    }
+                }
+            } else {
+                endEnvironment(pos, env);
+            }
+            return name_end;
+        }
+
+        if (name == "left") {
+            checkDelimiter(pos, name, end);
+            stack.push_back({Frame::Left, pos, ""});
+            return end;
+        }
+        if (name == "right" || name == "middle") {
+            checkDelimiter(pos, name, end);
+            if (stack.empty() || stack.back().kind != Frame::Left) {
+                report(LatexIssue::Error, pos, "\\" + name + " without matching \\left");
+            } else if (name == "right") {
+                stack.pop_back();
+            }
+            return end;
+        }
+
+        // Text mode arguments follow text rules ($, unknown macros, ...);
+        // step over them as long as their braces close
+        if (textMacros().count(name)) {
+            size_t open = skipSpaces(end);
+            size_t close = open < text.size() && text[open] == '{' ? skipGroup(open, '{', '}')
+                                                                    : std::string::npos;
+            if (close != std::string::npos) return close;
+        }
+
+        checkMacro(pos, name, end);
+        return end;
+    }
+
+    void endEnvironment(size_t pos, const std::string& env) {
+        if (stack.empty() || stack.back().kind != Frame::Environment) {
+            if (!stack.empty() && stack.back().kind == Frame::Left) {
+                report(LatexIssue::Error, stack.back().pos, "\\left is not closed before \\end{" + env + "}");
+            } else if (!stack.empty()) {
+                report(LatexIssue::Error, stack.back().pos, "Unclosed { before \\end{" + env + "}");
+            } else {
+                report(LatexIssue::Error, pos, "\\end{" + env + "} without matching \\begin");
+                return;
+            }
+            stack.pop_back();
+        }
+        if (stack.empty() || stack.back().kind != Frame::Environment) return;
+
+        if (stack.back().name != env) {
+            report(LatexIssue::Error, pos, "\\end{" + env + "} does not match \\begin{" +
+                   stack.back().name + "} at column " + std::to_string(column(stack.back().pos)));
+        }
+        stack.pop_back();
+    }
+
+public:
+    explicit Checker(const std::string& latex) : text(latex) {}
+
+    std::vector<LatexIssue> run() {
+        for (size_t pos = 0; pos < text.size(); pos++) {
+            char c = text[pos];
+            switch (c) {
+                case '%':
+                    // Comment to end of line
+                    while (pos + 1 < text.size() && text[pos + 1] != '\n') pos++;
+                    break;
+                case '#':
+                    report(LatexIssue::Error, pos, "# is only allowed in macro definitions (use \\#)");
+                    break;
+                case '$':
+                    report(LatexIssue::Error, pos, "$ is not needed, the equation is already in math mode");
+                    break;
+                case '^':
+                case '_':
+                    checkScripts(pos);
+                    break;
+                case '{':
+                    stack.push_back({Frame::Brace, pos, ""});
+                    break;
+                case '}':
+                    closeBrace(pos);
+                    break;
+                case '\\':
+                    pos = scanMacro(pos) - 1;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        for (const auto& frame : stack) {
+            switch (frame.kind) {
+                case Frame::Brace:
+                    report(LatexIssue::Error, frame.pos, "Unclosed {");
+                    break;
+                case Frame::Environment:
+                    report(LatexIssue::Error, frame.pos, "\\begin{" + frame.name + "} is never ended");
+                    break;
+                case Frame::Left:
+                    report(LatexIssue::Error, frame.pos, "\\left without matching \\right");
+                    break;
+            }
+        }
+        return issues;
+    }
+};
+
+}
+
+std::vector<LatexIssue> LatexValidator::check(const std::string& latex) {
+    return Checker(latex).run();
+}
+
+bool LatexValidator::hasErrors(const std::vector<LatexIssue>& issues) {
+    for (const auto& issue : issues) {
+        if (issue.severity == LatexIssue::Error) return true;
+    }
+    return false;
+}
+
+std::string LatexValidator::describe(const LatexIssue& issue) {
+    return "column " + std::to_string(issue.column) + ": " + issue.message;
+}
@@ -0,0 +1,34 @@
+// src/LatexValidator.hpp
+#ifndef LATEXVALIDATOR_HPP
+#define LATEXVALIDATOR_HPP
+
+#include <string>
+#include <vector>
+
+struct LatexIssue {
+    enum Severity { Error, Warning };
+
+    Severity severity;
+    size_t column;        // 1-based, in characters
+    std::string message;
+};
+
+// Quick structural check of the LaTeX typed into add_equation, run in
+// process so the common typos are reported in microseconds instead of
+// after Python, Manim and TeX have started. It knows MathTex wraps the
+// input in an align* environment. Errors are things TeX is certain to
+// reject (unbalanced braces and environments, a lone \right, missing
+// arguments of known macros, double scripts); macros and environments it
+// doesn't know are only warnings, since Manim's template loads packages
+// that define plenty more.
+class LatexValidator {
+public:
+    static std::vector<LatexIssue> check(const std::string& latex);
+
+    static bool hasErrors(const std::vector<LatexIssue>& issues);
+
+    // "column 7: \frac expects 2 arguments, found 1"
+    static std::string describe(const LatexIssue& issue);
+};
+
+#endif
@@ -0,0 +1,109 @@
+// src/ManimProgressParser.hpp
+#ifndef MANIMPROGRESSPARSER_HPP
+#define MANIMPROGRESSPARSER_HPP
+
+#include <cstdlib>
+#include <string>
+
+// Progress of one render as reported by Manim's per-animation bars
+struct RenderProgress {
+    int animation = 0;         // index of the animation being rendered
+    int animation_count = 0;   // plays + waits in the generated scene
+    int frame = 0;             // frames done in the current animation
+    int frame_count = 0;       // frames in the current animation
+    long total_frames = 0;     // frames done over the whole render
+    double percent = 0.0;      // overall, 0..100
+    double fps = 0.0;          // rendered frames per wall clock second
+};
+
+// Incremental parser for Manim's tqdm output. Manim redraws its bars with
+// '\r' and only ends a bar with '\n', so input is split on both and the
+// trailing partial line is kept until the next chunk arrives. Lines look like
+//   Animation 3: TransformFromCopy(...):  45%|####5     | 27/60 [00:00<...]
+//   Waiting 4:  100%|##########| 15/15 [00:00<00:00, 95.12it/s]
+class ManimProgressParser {
+private:
+    std::string partial;
+    int current_animation = -1;
+    int scene_base = 0;  // animations of the scenes already rendered by this run
+    int current_frame = 0;
+    int current_frame_count = 0;
+    long finished_frames = 0;  // frames of animations already completed
+
+    // Parse one bar line; returns true if it carried progress
+    bool parseLine(const std::string& line) {
+        size_t pos = line.find("Animation ");
+        size_t skip = 10;
+        if (pos == std::string::npos) {
+            pos = line.find("Waiting ");
+            skip = 8;
+        }
+        if (pos == std::string::npos) return false;
+
+        char* end = nullptr;
+        long index = std::strtol(line.c_str() + pos + skip, &end, 10);
+        if (end == line.c_str() + pos + skip) return false;
+
+        // "| 27/60 [" - frames done / frames in this animation
+        size_t bar_end = line.rfind('|');
+        if (bar_end == std::string::npos) return false;
+        const char* counts = line.c_str() + bar_end + 1;
+        long done = std::strtol(counts, &end, 10);
+        if (end == counts || *end != '/') return false;
+        const char* total_start = end + 1;
+        long total = std::strtol(total_start, &end, 10);
+        if (end == total_start) return false;
+
+        // Each scene numbers its animations from 0, so a smaller index
+        // means the run moved on to its next scene
+        int absolute = scene_base + static_cast<int>(index);
+        if (absolute < current_animation) {
+            scene_base = current_animation + 1;
+            absolute = scene_base + static_cast<int>(index);
+        }
+        if (absolute != current_animation) {
+            if (current_animation >= 0) finished_frames += current_frame_count;
+            current_animation = absolute;
+        }
+        current_frame = static_cast<int>(done);
+        current_frame_count = static_cast<int>(total);
+        return true;
+    }
+
+public:
+    // Feed raw output; returns true if any progress was parsed from it
+    bool feed(const char* data, size_t length) {
+        bool updated = false;
+        for (size_t i = 0; i < length; i++) {
+            char c = data[i];
+            if (c == '\r' || c == '\n') {
+                if (!partial.empty() && parseLine(partial)) updated = true;
+                partial.clear();
+            } else {
+                partial += c;
+            }
+        }
+        return updated;
+    }
+
+    bool started() const { return current_animation >= 0; }
+    int animation() const { return current_animation; }
+
+    // Fill the frame/animation fields of `progress`; animation_count must
+    // already be set so the overall percentage can be worked out
+    void fill(RenderProgress& progress) const {
+        progress.animation = current_animation < 0 ? 0 : current_animation;
+        progress.frame = current_frame;
+        progress.frame_count = current_frame_count;
+        progress.total_frames = finished_frames + current_frame;
+
+        double within = current_frame_count > 0
+            ? static_cast<double>(current_frame) / current_frame_count : 0.0;
+        if (progress.animation_count > 0) {
+            progress.percent = 100.0 * (progress.animation + within) / progress.animation_count;
+            if (progress.percent > 100.0) progress.percent = 100.0;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,134 @@
+// src/ManimScript.cpp
+#include "ManimScript.hpp"
+#include "JsonUtil.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+void ManimScript::emitEquation(std::ostream& out, const MathEquation& eq, size_t i) {
+    out << "{\"latex\": " << jsonQuote(eq.latex)
+        << ", \"x\": " << eq.x << ", \"y\": " << eq.y
+        << ", \"color\": " << jsonQuote(eq.color) << ", \"scale\": " << eq.scale;
+
+    // Different animation based on position
+    if (i == 0) {
+        out << ", \"animation\": \"write\"";
+    } else {
+        out << ", \"animation\": \"transform_from_copy\", \"from\": " << (i - 1);
+    }
+    out << ", \"wait\": " << WAIT_SECONDS << "}";
+}
+
+std::string ManimScript::document(const std::vector<MathEquation>& equations, size_t count,
+                                  const std::string& scenes) {
+    std::ostringstream data;
+    data << "{\"version\": " << FORMAT_VERSION << ",\n\"scenes\": [" << scenes << "],\n\"equations\": [";
+    for (size_t i = 0; i < count && i < equations.size(); i++) {
+        data << (i ? ",\n" : "\n");
+        emitEquation(data, equations[i], i);
+    }
+    data << "]}\n";
+    return data.str();
+}
+
+std::string ManimScript::scene(const std::vector<MathEquation>& equations, int first) {
+    // Without a range the data stays as it was, so cached videos still match
+    std::string range = first > 0 ? ", \"first\": " + std::to_string(first) : "";
+    return document(equations, equations.size(),
+                    "{\"name\": \"GeneratedScene\", \"kind\": \"full\"" + range + "}");
+}
+
+std::string ManimScript::still(const std::vector<MathEquation>& equations) {
+    return document(equations, equations.size(), "{\"name\": \"GeneratedScene\", \"kind\": \"still\"}");
+}
+
+std::string ManimScript::segments(const std::vector<MathEquation>& equations,
+                                  const std::vector<int>& indices) {
+    std::string scenes;
+    int last = -1;
+    for (int index : indices) {
+        scenes += (scenes.empty() ? "" : ", ");
+        scenes += "{\"name\": " + jsonQuote(segmentClassName(index)) +
+                  ", \"kind\": \"segment\", \"index\": " + std::to_string(index) + "}";
+        last = std::max(last, index);
+    }
+    // Segment i only needs equations 0..i
+    return document(equations, static_cast<size_t>(last + 1), scenes);
+}
+
+std::vector<std::string> ManimScript::segmentKeys(const std::vector<MathEquation>& equations, int first,
+                                                  Sha256 hasher) {
+    // Earlier equations stay on screen, so they are part of the segment's
+    // picture too; the data covers them, the equation it animates and the
+    // one it morphs from. The index comes last, after the shared prefix.
+    std::vector<std::string> keys;
+    hasher.update("{\"version\": " + std::to_string(FORMAT_VERSION) + ",\n\"kind\": \"segment\",\n\"equations\": [");
+    for (size_t i = 0; i < equations.size(); i++) {
+        hasher.update(i ? ",\n" : "\n").update(equationData(equations[i], i));
+        if (static_cast<int>(i) < first) continue;
+        Sha256 key = hasher;
+        keys.push_back(key.update("],\n\"index\": " + std::to_string(i) + "}\n").hexDigest());
+    }
+    return keys;
+}
+
+std::string ManimScript::segmentClassName(int index) {
+    return "Segment" + std::to_string(index);
+}
+
+std::string ManimScript::equationData(const MathEquation& equation, size_t index) {
+    std::ostringstream data;
+    emitEquation(data, equation, index);
+    return data.str();
+}
+
+int ManimScript::animationCount(const std::vector<MathEquation>& equations, int first) {
+    // One play and one wait per equation, or a single Write + wait for the
+    // placeholder text of an empty scene
+    int count = static_cast<int>(equations.size()) - std::max(first, 0);
+    return equations.empty() ? 2 : std::max(count, 0) * ANIMATIONS_PER_SEGMENT;
+}
+
+int ManimScript::animationAt(const std::vector<MathEquation>& equations, double seconds) {
+    int index = static_cast<int>(std::floor(seconds / (PLAY_SECONDS + WAIT_SECONDS)));
+    return std::clamp(index, 0, std::max(static_cast<int>(equations.size()) - 1, 0));
+}
+
+std::string ManimScript::dataPath(const std::string& script_path) {
+    return std::filesystem::path(script_path).replace_extension(".scene.json").string();
+}
+
+void ManimScript::writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open " + path + " for writing");
+    }
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Could not write " + path);
+    }
+}
+
+void ManimScript::write(const std::string& script_path, const std::string& data,
+                        const std::string& runner_dir) {
+    // The stub is the same for every render; Manim's CLI and the warm
+    // worker both load it like any scene file
+    std::string runner = std::filesystem::absolute(runner_dir).string();
+    std::string stub =
+        "# Generated by AmrMathMaker; the scene is described in the .scene.json beside this file\n"
+        "import os, sys\n"
+        "if " + jsonQuote(runner) + " not in sys.path:\n"
+        "    sys.path.insert(0, " + jsonQuote(runner) + ")\n"
+        "from scene_runner import scene_classes\n"
+        "globals().update(scene_classes(os.path.splitext(__file__)[0] + \".scene.json\", __name__))\n";
+
+    writeFile(dataPath(script_path), data);
+    writeFile(script_path, stub);
+    std::cout << "[C++] Scene data written: " << dataPath(script_path) << std::endl;
+}
@@ -0,0 +1,86 @@
+// src/ManimScript.hpp
+#ifndef MANIMSCRIPT_HPP
+#define MANIMSCRIPT_HPP
+
+#include "Equation.hpp"
+#include "Sha256.hpp"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Describes the scenes handed to Manim as data for python/scene_runner.py.
+//
+// A render writes a fixed stub script plus a JSON data file beside it
+// (render_output_3.py and render_output_3.scene.json); the stub asks the
+// runner to define the scene classes listed in the data. No Python is
+// generated per equation.
+//
+// The whole scene writes equation 0 and then morphs each equation out of a
+// copy of the one before it, leaving every equation on screen. Segment i is
+// the same scene cut at animation boundaries: equations 0..i-1 are added
+// without animating, then only animation i (and its wait) is played, so the
+// concatenated segments match the whole scene frame for frame. A range
+// render is the whole scene started the same way at a later animation.
+class ManimScript {
+public:
+    // Version of the data format; must match FORMAT_VERSION in scene_runner.py
+    static constexpr int FORMAT_VERSION = 1;
+
+    // Scene data for the full scene as class GeneratedScene; from
+    // animation `first` on, with the equations before it added unanimated
+    static std::string scene(const std::vector<MathEquation>& equations, int first = 0);
+
+    // Scene data for the last frame as class GeneratedScene: every
+    // equation added in its final form, nothing animated
+    static std::string still(const std::vector<MathEquation>& equations);
+
+    // Scene data with a SegmentN class for each index in `indices`
+    static std::string segments(const std::vector<MathEquation>& equations,
+                                const std::vector<int>& indices);
+
+    // Cache keys of segments `first`.. of the scene: `hasher` finished over
+    // everything segment i's frames depend on. That is equations 0..i, so
+    // the data is hashed once as a growing prefix and each key finishes a
+    // copy of it, rather than hashing i equations again for every segment.
+    static std::vector<std::string> segmentKeys(const std::vector<MathEquation>& equations, int first,
+                                                Sha256 hasher);
+
+    static std::string segmentClassName(int index);
+
+    // Equation i's entry in the scene data: what it contributes to the
+    // frames of every segment from i on
+    static std::string equationData(const MathEquation& equation, size_t index);
+
+    // Number of progress bars (plays and waits) Manim shows for the scene,
+    // from animation `first` on
+    static int animationCount(const std::vector<MathEquation>& equations, int first = 0);
+
+    // Progress bars per segment
+    static constexpr int ANIMATIONS_PER_SEGMENT = 2;
+
+    // Length of each equation's play (Manim's default run_time) and the
+    // wait after it
+    static constexpr double PLAY_SECONDS = 1.0;
+    static constexpr double WAIT_SECONDS = 0.5;
+
+    // Animation playing `seconds` into the full scene, clamped to the scene
+    static int animationAt(const std::vector<MathEquation>& equations, double seconds);
+
+    // The data file read by the stub script at `script_path`
+    static std::string dataPath(const std::string& script_path);
+
+    // Write `data` and the stub script that hands it to the runner in
+    // `runner_dir`
+    static void write(const std::string& script_path, const std::string& data,
+                      const std::string& runner_dir);
+
+private:
+    // The data document: the first `count` equations and the scene list
+    static std::string document(const std::vector<MathEquation>& equations, size_t count,
+                                const std::string& scenes);
+    static void emitEquation(std::ostream& out, const MathEquation& eq, size_t index);
+    static void writeFile(const std::string& path, const std::string& contents);
+};
+
+#endif
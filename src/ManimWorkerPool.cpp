@@ -0,0 +1,101 @@
+// src/ManimWorkerPool.cpp
+#include "ManimWorkerPool.hpp"
+
+#include <cerrno>
+#include <iostream>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+ManimWorkerPool::~ManimWorkerPool() {
+    shutdown();
+}
+
+void ManimWorkerPool::setWorkerScript(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    worker_script = path;
+}
+
+bool ManimWorkerPool::enabled() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !worker_script.empty();
+}
+
+void ManimWorkerPool::setMaxIdle(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    max_idle = count;
+}
+
+// Caller holds `mutex`
+std::unique_ptr<ManimWorker> ManimWorkerPool::spawn() {
+    // Requests are written to the worker's stdin; a worker that died
+    // between renders must not take the whole app down with SIGPIPE
+    signal(SIGPIPE, SIG_IGN);
+
+    auto worker = std::make_unique<ManimWorker>();
+    worker->process = spawnProcessGroup({python, "-u", worker_script}, true);
+    std::cout << "[C++] Started Manim worker (pid " << worker->process.pid << ")" << std::endl;
+    return worker;
+}
+
+bool ManimWorkerPool::alive(ManimWorker& worker) {
+    int status;
+    return worker.process.running() && waitpid(worker.process.pid, &status, WNOHANG) == 0;
+}
+
+void ManimWorkerPool::terminate(ManimWorker& worker) {
+    if (!worker.process.running()) return;
+    signalProcessGroup(worker.process, SIGKILL);
+    waitProcess(worker.process);
+}
+
+std::unique_ptr<ManimWorker> ManimWorkerPool::acquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+    while (!idle.empty()) {
+        std::unique_ptr<ManimWorker> worker = std::move(idle.back());
+        idle.pop_back();
+        if (alive(*worker)) return worker;
+
+        // Died while idle (OOM killer, python crash): reap it and move on
+        std::cerr << "[C++] Manim worker " << worker->process.pid << " died while idle" << std::endl;
+        terminate(*worker);
+    }
+    return spawn();
+}
+
+void ManimWorkerPool::release(std::unique_ptr<ManimWorker> worker) {
+    worker->renders++;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (idle.size() < max_idle && !worker_script.empty()) {
+        idle.push_back(std::move(worker));
+        return;
+    }
+    // Already enough warm workers
+    terminate(*worker);
+}
+
+void ManimWorkerPool::discard(std::unique_ptr<ManimWorker> worker) {
+    terminate(*worker);
+    prewarm();
+}
+
+void ManimWorkerPool::prewarm() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (worker_script.empty() || !idle.empty() || max_idle == 0) return;
+    try {
+        idle.push_back(spawn());
+    } catch (const std::exception& e) {
+        std::cerr << "[C++] Could not start Manim worker: " << e.what() << std::endl;
+    }
+}
+
+void ManimWorkerPool::shutdown() {
+    std::vector<std::unique_ptr<ManimWorker>> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        workers.swap(idle);
+    }
+    for (auto& worker : workers) {
+        terminate(*worker);
+    }
+}
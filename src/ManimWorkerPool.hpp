@@ -0,0 +1,69 @@
+// src/ManimWorkerPool.hpp
+#ifndef MANIMWORKERPOOL_HPP
+#define MANIMWORKERPOOL_HPP
+
+#include "ChildProcess.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Marker lines printed by python/manim_worker.py
+constexpr const char* MANIM_WORKER_READY = "@@AMR_READY";
+constexpr const char* MANIM_WORKER_DONE = "@@AMR_DONE";
+constexpr const char* MANIM_WORKER_SCENE = "@@AMR_SCENE";
+
+// A long-lived Python process that has already imported manim and renders
+// one request at a time from JSON lines on its stdin
+struct ManimWorker {
+    ChildProcess process;
+    int renders = 0;
+};
+
+// Keeps warm Manim workers around so a render doesn't pay Python startup
+// and the manim import (2-4s) every time. Workers are started lazily; a
+// job checks one out, and gives it back when the render finished cleanly
+// or discards it after a crash or cancel, when a replacement is warmed up.
+class ManimWorkerPool {
+private:
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ManimWorker>> idle;
+    std::string python = "python";
+    std::string worker_script;
+    // Each idle worker holds a Python with manim imported, a few hundred
+    // MB, for the rest of the session. A parallel render starts the extra
+    // ones it needs and they exit when it is done.
+    size_t max_idle = 2;
+
+    std::unique_ptr<ManimWorker> spawn();
+    static bool alive(ManimWorker& worker);
+    static void terminate(ManimWorker& worker);
+
+public:
+    ~ManimWorkerPool();
+
+    // Path of manim_worker.py; warm workers are disabled while it's empty
+    void setWorkerScript(const std::string& path);
+    bool enabled();
+
+    // How many finished workers to keep warm for the next render
+    void setMaxIdle(size_t count);
+
+    // An idle worker, or a freshly started one (still importing manim)
+    std::unique_ptr<ManimWorker> acquire();
+
+    // Return a worker that finished its request normally
+    void release(std::unique_ptr<ManimWorker> worker);
+
+    // Kill a worker that crashed or was cancelled and start warming a
+    // replacement so the next render doesn't pay for the restart
+    void discard(std::unique_ptr<ManimWorker> worker);
+
+    // Start a worker in the background if none is idle
+    void prewarm();
+
+    void shutdown();
+};
+
+#endif
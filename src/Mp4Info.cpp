@@ -0,0 +1,73 @@
+// src/Mp4Info.cpp
+#include "Mp4Info.hpp"
+
+#include <cstdint>
+#include <fstream>
+
+namespace {
+
+uint64_t readBigEndian(std::istream& in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        int c = in.get();
+        if (c == EOF) return 0;
+        value = (value << 8) | static_cast<uint8_t>(c);
+    }
+    return value;
+}
+
+// Walk the boxes in [begin, end) and leave `in` at the body of the first
+// one of type `type`; false if there is none
+bool findBox(std::istream& in, uint64_t begin, uint64_t end, const char* type, uint64_t& body_end) {
+    uint64_t pos = begin;
+    while (pos + 8 <= end) {
+        in.seekg(static_cast<std::streamoff>(pos));
+        uint64_t size = readBigEndian(in, 4);
+        char name[4];
+        if (!in.read(name, 4)) return false;
+        uint64_t header = 8;
+        if (size == 1) {
+            size = readBigEndian(in, 8);
+            header = 16;
+        } else if (size == 0) {
+            size = end - pos;  // runs to the end of its parent
+        }
+        if (size < header || pos + size > end) return false;
+        if (name[0] == type[0] && name[1] == type[1] && name[2] == type[2] && name[3] == type[3]) {
+            in.seekg(static_cast<std::streamoff>(pos + header));
+            body_end = pos + size;
+            return true;
+        }
+        pos += size;
+    }
+    return false;
+}
+
+}
+
+double mp4Duration(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return -1.0;
+    uint64_t file_size = static_cast<uint64_t>(in.tellg());
+
+    // ffmpeg writes moov after mdat unless asked for faststart, so the
+    // top level is walked box by box rather than read from the front
+    uint64_t moov_end, mvhd_end;
+    if (!findBox(in, 0, file_size, "moov", moov_end)) return -1.0;
+    if (!findBox(in, static_cast<uint64_t>(in.tellg()), moov_end, "mvhd", mvhd_end)) return -1.0;
+
+    int version = in.get();
+    in.ignore(3);  // flags
+    uint64_t timescale, duration;
+    if (version == 1) {
+        in.ignore(16);  // creation and modification time
+        timescale = readBigEndian(in, 4);
+        duration = readBigEndian(in, 8);
+    } else {
+        in.ignore(8);
+        timescale = readBigEndian(in, 4);
+        duration = readBigEndian(in, 4);
+    }
+    if (!in || timescale == 0) return -1.0;
+    return static_cast<double>(duration) / timescale;
+}
@@ -0,0 +1,12 @@
+// src/Mp4Info.hpp
+#ifndef MP4INFO_HPP
+#define MP4INFO_HPP
+
+#include <string>
+
+// Duration of an MP4 in seconds, read from its movie header box (mvhd)
+// without decoding anything or starting ffprobe; negative if the file
+// can't be read or has no movie header
+double mp4Duration(const std::string& path);
+
+#endif
@@ -0,0 +1,60 @@
+// src/OutputRing.hpp
+#ifndef OUTPUTRING_HPP
+#define OUTPUTRING_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+// Keeps the last `capacity` bytes of a child's output. A long verbose
+// render only ever costs this much memory; the head of the output is
+// dropped and counted instead.
+class OutputRing {
+private:
+    std::string buffer;
+    size_t capacity;
+    size_t head = 0;        // next write position once the buffer is full
+    uint64_t total = 0;     // bytes ever appended
+
+public:
+    explicit OutputRing(size_t capacity = 64 * 1024) : capacity(capacity ? capacity : 1) {}
+
+    void append(const char* data, size_t length) {
+        total += length;
+        if (length >= capacity) {
+            buffer.assign(data + length - capacity, capacity);
+            head = 0;
+            return;
+        }
+        // Fill up to capacity first, then overwrite the oldest bytes
+        size_t grow = std::min(capacity - buffer.size(), length);
+        buffer.append(data, grow);
+        data += grow;
+        length -= grow;
+        while (length > 0) {
+            size_t chunk = std::min(capacity - head, length);
+            buffer.replace(head, chunk, data, chunk);
+            head = (head + chunk) % capacity;
+            data += chunk;
+            length -= chunk;
+        }
+    }
+
+    void append(const std::string& text) { append(text.data(), text.size()); }
+
+    // Retained output, oldest first
+    std::string str() const {
+        if (buffer.size() < capacity || head == 0) return buffer;
+        return buffer.substr(head) + buffer.substr(0, head);
+    }
+
+    uint64_t totalBytes() const { return total; }
+    bool truncated() const { return total > buffer.size(); }
+    void clear() {
+        buffer.clear();
+        head = 0;
+        total = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,71 @@
+// src/PreviewScheduler.cpp
+#include "PreviewScheduler.hpp"
+#include <algorithm>
+#include <iostream>
+
+void PreviewScheduler::onTimer(ClientData data) {
+    PreviewScheduler* self = static_cast<PreviewScheduler*>(data);
+    self->timer = nullptr;
+    self->renderNow();
+}
+
+void PreviewScheduler::cancelCurrent() {
+    int job_id = current_job.exchange(0);
+    if (job_id != 0) render_manager.cancel(job_id);
+}
+
+void PreviewScheduler::sceneChanged() {
+    if (!enabled) return;
+    cancelCurrent();
+    if (timer) Tcl_DeleteTimerHandler(timer);
+    timer = Tcl_CreateTimerHandler(delay_ms, onTimer, this);
+}
+
+void PreviewScheduler::renderNow() {
+    if (timer) {
+        Tcl_DeleteTimerHandler(timer);
+        timer = nullptr;
+    }
+    cancelCurrent();
+
+    // The previous preview is either cancelled (and cleaned up by its
+    // worker) or already on screen; Tk keeps its own copy of the pixels
+    if (!last_script.empty()) {
+        RenderManager::removeJobOutput(last_script);
+        last_script.clear();
+    }
+
+    std::vector<MathEquation> equations = scene_manager.snapshot();
+    if (equations.empty()) return;
+
+    RenderOptions options;
+    options.quality = "-ql";
+    options.filename = "preview";
+    options.priority = RENDER_PRIORITY_PREVIEW;
+    options.still_frame = true;
+    options.width = width;
+    options.height = height;
+    int job_id = render_manager.submit(options, std::move(equations));
+    last_script = RenderManager::scriptPath(options, job_id);
+    current_job = job_id;
+    std::cout << "[C++] Preview job #" << job_id << " (" << width << "x" << height << ")" << std::endl;
+}
+
+void PreviewScheduler::setEnabled(bool enabled) {
+    this->enabled = enabled;
+    if (!enabled) stop();
+}
+
+void PreviewScheduler::setSize(int width, int height) {
+    // A canvas that is not mapped yet reports 1x1
+    this->width = std::max(16, width);
+    this->height = std::max(16, height);
+}
+
+void PreviewScheduler::stop() {
+    if (timer) {
+        Tcl_DeleteTimerHandler(timer);
+        timer = nullptr;
+    }
+    cancelCurrent();
+}
@@ -0,0 +1,60 @@
+// src/PreviewScheduler.hpp
+#ifndef PREVIEWSCHEDULER_HPP
+#define PREVIEWSCHEDULER_HPP
+
+#include <tcl.h>
+
+#include "RenderManager.hpp"
+#include "SceneManager.hpp"
+
+#include <atomic>
+#include <string>
+
+// Renders a low resolution still of the scene's last frame shortly after
+// each edit. Edits arriving within `delay_ms` of each other are coalesced
+// into one render, and an edit cancels the preview still in flight, so
+// only the newest picture of the scene is ever worked on. Lives on the
+// interpreter thread; the debounce is a Tcl timer.
+class PreviewScheduler {
+private:
+    RenderManager& render_manager;
+    SceneManager& scene_manager;
+
+    Tcl_TimerToken timer = nullptr;
+    bool enabled = true;
+    int delay_ms = 300;
+    int width = 480, height = 270;
+
+    std::atomic<int> current_job{0};
+    std::string last_script;  // newest preview's scene file, deleted by the next
+
+    static void onTimer(ClientData data);
+    void cancelCurrent();
+
+public:
+    PreviewScheduler(RenderManager& render_manager, SceneManager& scene_manager)
+        : render_manager(render_manager), scene_manager(scene_manager) {}
+
+    // The scene changed: restart the debounce and drop the stale preview
+    void sceneChanged();
+
+    // Render now, skipping the debounce
+    void renderNow();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+    void setDelay(int ms) { delay_ms = ms < 0 ? 0 : ms; }
+    int delay() const { return delay_ms; }
+    void setSize(int width, int height);
+    int previewWidth() const { return width; }
+    int previewHeight() const { return height; }
+
+    // Id of the newest preview job, 0 if none; a finished preview with any
+    // other id is stale. Safe to call from any thread.
+    int currentJob() const { return current_job; }
+
+    // Cancel the timer and the running preview
+    void stop();
+};
+
+#endif
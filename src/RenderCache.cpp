@@ -0,0 +1,132 @@
+// src/RenderCache.cpp
+#include "RenderCache.hpp"
+#include "Sha256.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Bump when the script generator or cache layout changes in a way that
+// makes old entries wrong for the same key input
+static const char* CACHE_FORMAT = "amr-render-cache-v1";
+
+void RenderCache::setDirectory(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    directory = path;
+}
+
+void RenderCache::setMaxBytes(uintmax_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    max_bytes = bytes;
+    evict();
+}
+
+uintmax_t RenderCache::maxBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return max_bytes;
+}
+
+std::string RenderCache::key(const std::string& scene_data, const std::string& quality) {
+    return keyHasher(quality).update(scene_data).hexDigest();
+}
+
+Sha256 RenderCache::keyHasher(const std::string& quality) {
+    Sha256 sha;
+    sha.update(CACHE_FORMAT).update("\n", 1);
+    sha.update(quality).update("\n", 1);
+    return sha;
+}
+
+bool RenderCache::lookup(const std::string& key, std::string& video_path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    fs::path entry = directory / (key + ".mp4");
+    std::error_code ec;
+    if (!fs::is_regular_file(entry, ec)) {
+        misses++;
+        return false;
+    }
+
+    // mtime doubles as the LRU timestamp
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+    hits++;
+    video_path = entry.string();
+    return true;
+}
+
+bool RenderCache::contains(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::error_code ec;
+    return fs::is_regular_file(directory / (key + ".mp4"), ec);
+}
+
+std::string RenderCache::store(const std::string& key, const std::string& video_path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+
+    // Copy under a temporary name and rename, so a concurrent lookup never
+    // sees a half written file
+    fs::path entry = directory / (key + ".mp4");
+    fs::path temp = directory / (key + ".tmp");
+    fs::copy_file(video_path, temp, fs::copy_options::overwrite_existing, ec);
+    if (!ec) fs::rename(temp, entry, ec);
+    if (ec) {
+        std::cerr << "[C++] Could not cache " << video_path << ": " << ec.message() << std::endl;
+        fs::remove(temp, ec);
+        return "";
+    }
+
+    evict();
+    return entry.string();
+}
+
+void RenderCache::evict() {
+    struct Entry {
+        fs::path path;
+        fs::file_time_type used;
+        uintmax_t size;
+    };
+    std::vector<Entry> entries;
+    uintmax_t total = 0;
+
+    std::error_code ec;
+    for (const auto& file : fs::directory_iterator(directory, ec)) {
+        if (!file.is_regular_file(ec) || file.path().extension() != ".mp4") continue;
+        Entry entry{file.path(), file.last_write_time(ec), file.file_size(ec)};
+        total += entry.size;
+        entries.push_back(entry);
+    }
+    if (total <= max_bytes) return;
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const auto& entry : entries) {
+        if (total <= max_bytes) break;
+        if (fs::remove(entry.path, ec)) total -= entry.size;
+    }
+}
+
+RenderCache::Stats RenderCache::stats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result;
+    result.hits = hits;
+    result.misses = misses;
+
+    std::error_code ec;
+    for (const auto& file : fs::directory_iterator(directory, ec)) {
+        if (!file.is_regular_file(ec) || file.path().extension() != ".mp4") continue;
+        result.entries++;
+        result.bytes += file.file_size(ec);
+    }
+    return result;
+}
+
+void RenderCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::error_code ec;
+    for (const auto& file : fs::directory_iterator(directory, ec)) {
+        if (file.path().extension() == ".mp4") fs::remove(file.path(), ec);
+    }
+}
@@ -0,0 +1,60 @@
+// src/RenderCache.hpp
+#ifndef RENDERCACHE_HPP
+#define RENDERCACHE_HPP
+
+#include "Sha256.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+// On-disk cache of finished videos, addressed by a hash of the scene data
+// (see ManimScript) and the quality flag. Entries are plain <key>.mp4 files; the
+// least recently used ones are deleted once the cache grows past its limit.
+class RenderCache {
+public:
+    struct Stats {
+        size_t entries = 0;
+        uintmax_t bytes = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+private:
+    std::mutex mutex;
+    std::filesystem::path directory = "render_cache";
+    uintmax_t max_bytes = uintmax_t(2) << 30;  // 2 GiB
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    // Caller holds `mutex`
+    void evict();
+
+public:
+    void setDirectory(const std::string& path);
+    void setMaxBytes(uintmax_t bytes);
+    uintmax_t maxBytes();
+
+    // Key for scene data rendered at `quality`
+    static std::string key(const std::string& scene_data, const std::string& quality);
+
+    // The hasher key() feeds the scene data into, for callers that build
+    // many keys over shared data; its hexDigest() is the key
+    static Sha256 keyHasher(const std::string& quality);
+
+    // Path of the cached video for `key`, marking it recently used
+    bool lookup(const std::string& key, std::string& video_path);
+
+    // Whether `key` is cached, without counting a hit or miss or touching it
+    bool contains(const std::string& key);
+
+    // Copy a freshly rendered video into the cache; returns the cached path,
+    // or an empty string if it could not be stored
+    std::string store(const std::string& key, const std::string& video_path);
+
+    Stats stats();
+    void clear();
+};
+
+#endif
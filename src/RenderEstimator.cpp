@@ -0,0 +1,168 @@
+// src/RenderEstimator.cpp
+#include "RenderEstimator.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace {
+
+// Pixels times frames per second at each quality flag, what Manim's work
+// per second of video grows with
+double qualityCost(const std::string& quality) {
+    if (quality == "-ql") return 854.0 * 480 * 15;
+    if (quality == "-qm") return 1280.0 * 720 * 30;
+    if (quality == "-qh") return 1920.0 * 1080 * 60;
+    if (quality == "-qp") return 2560.0 * 1440 * 60;
+    if (quality == "-qk") return 3840.0 * 2160 * 60;
+    return 0.0;
+}
+
+void features(const RenderWork& work, double x[4]) {
+    x[0] = 1.0;
+    x[1] = work.writes;
+    x[2] = work.transforms;
+    x[3] = work.tex_tokens;
+}
+
+// Solve the n x n system a x = b in place by Gaussian elimination with
+// partial pivoting; false if it is singular
+bool solve(double a[4][4], double b[4], int n) {
+    for (int col = 0; col < n; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < n; row++) {
+            if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) pivot = row;
+        }
+        if (std::fabs(a[pivot][col]) < 1e-12) return false;
+        std::swap(a[pivot], a[col]);
+        std::swap(b[pivot], b[col]);
+        for (int row = col + 1; row < n; row++) {
+            double factor = a[row][col] / a[col][col];
+            for (int k = col; k < n; k++) a[row][k] -= factor * a[col][k];
+            b[row] -= factor * b[col];
+        }
+    }
+    for (int row = n - 1; row >= 0; row--) {
+        for (int k = row + 1; k < n; k++) b[row] -= a[row][k] * b[k];
+        b[row] /= a[row][row];
+    }
+    return true;
+}
+
+}
+
+int RenderEstimator::latexTokens(const std::string& latex) {
+    int tokens = 0;
+    for (size_t i = 0; i < latex.size(); i++) {
+        char c = latex[i];
+        if (c == '\\') {
+            // \alpha is one token, as is an escaped character like \{
+            size_t end = i + 1;
+            while (end < latex.size() && std::isalpha(static_cast<unsigned char>(latex[end]))) end++;
+            i = std::max(end, i + 2) - 1;
+            tokens++;
+        } else if (c != '{' && c != '}' && !std::isspace(static_cast<unsigned char>(c))) {
+            tokens++;
+        }
+    }
+    return tokens;
+}
+
+RenderEstimator::Model RenderEstimator::fit(const std::vector<RenderTelemetry::Record>& records) {
+    Model model;
+    double seconds = 0.0, animations = 0.0;
+    double xtx[4][4] = {};
+    double xty[4] = {};
+    for (const auto& record : records) {
+        double x[4];
+        features(record.work, x);
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) xtx[i][j] += x[i] * x[j];
+            xty[i] += x[i] * record.total_seconds;
+        }
+        seconds += record.total_seconds;
+        animations += record.work.animations + 1;  // +1 for the start-up every render pays
+    }
+    model.samples = static_cast<int>(records.size());
+    model.seconds_per_animation = animations > 0.0 ? seconds / animations : 0.0;
+    if (model.samples < MIN_SAMPLES) return model;
+
+    // A little ridge keeps the fit solvable when a feature never varies,
+    // e.g. every render so far started with the same Write
+    for (int i = 1; i < 4; i++) xtx[i][i] += 1e-3 * (1.0 + xtx[i][i]);
+    model.fitted = solve(xtx, xty, 4);
+    if (model.fitted) std::copy(xty, xty + 4, model.coefficients);
+    return model;
+}
+
+void RenderEstimator::refit() {
+    long generation = telemetry.generation();
+    if (generation == fitted_generation) return;
+    fitted_generation = generation;
+    models.clear();
+
+    std::vector<RenderTelemetry::Record> records;
+    std::string error;
+    if (!telemetry.recent(HISTORY, records, error)) return;
+
+    // Whole-video cache hits and failures say nothing about render time
+    std::map<std::pair<std::string, bool>, std::vector<RenderTelemetry::Record>> groups;
+    for (auto& record : records) {
+        if (record.state != "done" || record.cache_hit || record.work.animations < 0) continue;
+        groups[{record.quality, record.still}].push_back(std::move(record));
+    }
+    for (const auto& [key, group] : groups) models[key] = fit(group);
+}
+
+RenderEstimator::Estimate RenderEstimator::estimate(const RenderOptions& options, const RenderWork& work) {
+    Estimate result;
+    if (work.cached) {
+        result.seconds = 0.0;
+        result.basis = "cache";
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    refit();
+    auto it = models.find({options.quality, options.still_frame});
+    if (it != models.end() && it->second.fitted) {
+        double x[4];
+        features(work, x);
+        double seconds = 0.0;
+        for (int i = 0; i < 4; i++) seconds += it->second.coefficients[i] * x[i];
+        // A fit over few, similar scenes can extrapolate below zero
+        if (seconds > 0.0) {
+            result.seconds = seconds;
+            result.samples = it->second.samples;
+            result.basis = "model";
+            return result;
+        }
+    }
+    if (it != models.end() && it->second.samples > 0) {
+        result.seconds = it->second.seconds_per_animation * (work.animations + 1);
+        result.samples = it->second.samples;
+        result.basis = "rate";
+        return result;
+    }
+
+    // Nothing at this quality yet: take the best known quality's rate and
+    // scale it by how much more work each frame is
+    const Model* known = nullptr;
+    std::string known_quality;
+    for (const auto& [key, model] : models) {
+        if (key.second != options.still_frame || qualityCost(key.first) <= 0.0) continue;
+        if (!known || model.samples > known->samples) {
+            known = &model;
+            known_quality = key.first;
+        }
+    }
+    double cost = qualityCost(options.quality);
+    if (known && cost > 0.0) {
+        result.seconds = known->seconds_per_animation * (work.animations + 1) * cost / qualityCost(known_quality);
+        result.samples = known->samples;
+        result.basis = "scaled";
+        return result;
+    }
+    result.basis = "none";
+    return result;
+}
@@ -0,0 +1,64 @@
+// src/RenderEstimator.hpp
+#ifndef RENDERESTIMATOR_HPP
+#define RENDERESTIMATOR_HPP
+
+#include "RenderJob.hpp"
+#include "RenderTelemetry.hpp"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+// Predicts how long a render will take from what it has to do (see
+// RenderWork), using the renders recorded in RenderTelemetry on this
+// machine. Each quality, and stills apart from videos, gets its own least
+// squares fit of
+//
+//   seconds = base + a * writes + b * transforms + c * tex_tokens
+//
+// over its recent successful renders. With too few of those it falls back
+// to seconds per animation, and with none at that quality to another
+// quality's rate scaled by the pixel count. Models are refit when new
+// renders have been recorded.
+class RenderEstimator {
+public:
+    struct Estimate {
+        double seconds = -1.0;  // negative: no renders to go by yet
+        int samples = 0;        // renders the estimate is based on
+        std::string basis;      // "model", "rate", "scaled", "cache" or "none"
+    };
+
+private:
+    struct Model {
+        bool fitted = false;           // coefficients are usable
+        double coefficients[4] = {};   // base, writes, transforms, tex_tokens
+        double seconds_per_animation = 0.0;
+        int samples = 0;
+    };
+
+    RenderTelemetry& telemetry;
+    std::mutex mutex;
+    std::map<std::pair<std::string, bool>, Model> models;  // by quality and still
+    long fitted_generation = -1;
+
+    // Caller holds `mutex`
+    void refit();
+    static Model fit(const std::vector<RenderTelemetry::Record>& records);
+
+public:
+    // Renders fitted on: the newest ones, so the model follows the machine
+    static constexpr int HISTORY = 500;
+    // Fewer renders than this and the model falls back to a rate
+    static constexpr int MIN_SAMPLES = 8;
+
+    explicit RenderEstimator(RenderTelemetry& telemetry) : telemetry(telemetry) {}
+
+    Estimate estimate(const RenderOptions& options, const RenderWork& work);
+
+    // Tokens of a LaTeX string: each control sequence counts once, every
+    // other character but spaces and braces once
+    static int latexTokens(const std::string& latex);
+};
+
+#endif
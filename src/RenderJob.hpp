@@ -0,0 +1,137 @@
+// src/RenderJob.hpp
+#ifndef RENDERJOB_HPP
+#define RENDERJOB_HPP
+
+#include "Equation.hpp"
+#include "ChildProcess.hpp"
+#include "ManimProgressParser.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <vector>
+
+// Named job priorities; any integer works and higher runs first
+constexpr int RENDER_PRIORITY_BACKGROUND = -50;
+constexpr int RENDER_PRIORITY_EXPORT = 0;
+constexpr int RENDER_PRIORITY_NORMAL = 50;
+constexpr int RENDER_PRIORITY_PREVIEW = 100;
+
+// "preview", "normal", "export", "background" or an integer
+inline bool parseRenderPriority(const std::string& text, int& priority) {
+    if (text == "preview") priority = RENDER_PRIORITY_PREVIEW;
+    else if (text == "normal") priority = RENDER_PRIORITY_NORMAL;
+    else if (text == "export") priority = RENDER_PRIORITY_EXPORT;
+    else if (text == "background") priority = RENDER_PRIORITY_BACKGROUND;
+    else {
+        char* end = nullptr;
+        long value = std::strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0') return false;
+        priority = static_cast<int>(value);
+    }
+    return true;
+}
+
+// Render options parsed from the render_scene command
+struct RenderOptions {
+    std::string quality = "-ql";  // -ql (low), -qm (medium), -qh (high)
+    std::string filename = "render_output";
+    bool open_after_render = false;
+    int priority = RENDER_PRIORITY_NORMAL;
+    bool still_frame = false;  // only the last frame, as a PNG (manim -s)
+    int width = 0, height = 0; // pixel size overriding the quality's; 0 keeps it
+    // Animations to render, 0-based and inclusive (-1: through the last).
+    // The ones before the range are set up as they end, without being
+    // animated, and the ones after it are left out.
+    int first_animation = 0, last_animation = -1;
+};
+
+enum class RenderState {
+    Queued,
+    Running,
+    Succeeded,
+    Failed,
+    Cancelled
+};
+
+inline const char* renderStateName(RenderState state) {
+    switch (state) {
+        case RenderState::Queued:    return "queued";
+        case RenderState::Running:   return "running";
+        case RenderState::Succeeded: return "done";
+        case RenderState::Failed:    return "failed";
+        case RenderState::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+// Live resource use of a running job's process trees, sampled by the
+// RenderManager's monitor
+struct RenderResources {
+    int processes = 0;
+    double cpu_percent = 0.0;     // 100 is one core busy, over the last interval
+    double cpu_seconds = 0.0;     // of the processes alive now
+    long rss_kb = 0;
+    long peak_rss_kb = 0;
+    uint64_t read_bytes = 0;
+    uint64_t write_bytes = 0;
+    std::chrono::steady_clock::time_point sampled_at;
+};
+
+// What a render has to do once the caches have had their say: the
+// features its running time is estimated from
+struct RenderWork {
+    int animations = 0;      // to render; an empty scene's placeholder counts as one
+    int writes = 0;          // of those, Write animations
+    int transforms = 0;      // of those, TransformFromCopy animations
+    int tex_tokens = 0;      // LaTeX tokens of the equations they animate (all of them for a still)
+    bool cached = false;     // the whole video is in the render cache
+};
+
+// What a render does with one of the assets it is built from (see
+// AssetGraph)
+struct AssetDecision {
+    std::string node;      // "tex 2", "segment 3", "video" or "still"
+    std::string hash;      // of its content
+    bool rebuild = false;
+    std::string reason;
+};
+
+// One render request. The equations are copied out of the SceneManager
+// when the job is submitted so the worker never touches live scene state.
+struct RenderJob {
+    int id = 0;
+    RenderOptions options;
+    std::vector<MathEquation> equations;
+
+    RenderState state = RenderState::Queued;
+    std::string message;     // human readable result or error
+    std::string video_path;  // set when Manim reports "File ready at"
+    RenderProgress progress; // latest progress parsed from Manim's output
+
+    std::string script_path;      // generated scene, also names Manim's media dir
+    std::set<int> process_groups; // pgids of the running Manim/ffmpeg process trees
+    bool cancel_requested = false;
+    bool cache_hit = false;       // video came from the render cache
+    int segments_total = 0;       // segments in the scene (segmented renders)
+    int segments_rendered = 0;    // of those, not found in the segment cache
+    ProcessUsage usage;           // CPU time and peak RSS of the reaped processes
+    int exit_status = 0;          // of the last process that failed, 128+signal if killed
+    size_t scene_bytes = 0;       // size of the scene data handed to Manim
+    std::vector<std::pair<std::string, double>> stage_seconds;  // wall time per stage, in first-run order
+    RenderResources resources;    // latest sample while running
+    double video_seconds = 0.0;   // length of the finished video
+    std::vector<double> animation_starts;  // where each animation begins in it, seconds
+    std::string stop_reason;      // why the watchdog stopped it; empty otherwise
+    RenderWork work;              // planned after submission, again when it starts
+    double estimated_seconds = -1.0;  // predicted when first planned; negative when unknown
+    std::vector<AssetDecision> assets;  // planned like `work`
+    bool planned = false;         // `estimated_seconds` is final
+
+    int depends_on = 0;           // stays queued until this job has finished
+    int upgrade_job = 0;          // progressive draft: the high quality job replacing it
+
+    std::chrono::steady_clock::time_point submitted_at, started_at, finished_at;
+};
+
+#endif
@@ -0,0 +1,1435 @@
+// src/RenderManager.cpp
+#include "RenderManager.hpp"
+#include "JsonUtil.hpp"
+#include "ManimScript.hpp"
+#include "Mp4Info.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <filesystem>
+#include <stdexcept>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+RenderManager::RenderManager() {
+    segment_cache.setDirectory("render_cache/segments");
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    setRenderParallelism(cores);
+    setMaxConcurrent(cores);
+
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page_size > 0) limits.memory_kb = pages / 4 * 3 * (page_size / 1024);
+    monitor_thread = std::thread(&RenderManager::monitorLoop, this);
+    planner_thread = std::thread(&RenderManager::planLoop, this);
+}
+
+RenderManager::~RenderManager() {
+    shutdown();
+}
+
+void RenderManager::setFinishedCallback(FinishedCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    finished_callback = callback;
+}
+
+void RenderManager::setProgressCallback(ProgressCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    progress_callback = callback;
+}
+
+void RenderManager::setSegmentCallback(SegmentCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    segment_callback = callback;
+}
+
+void RenderManager::setPlannedCallback(PlannedCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    planned_callback = callback;
+}
+
+void RenderManager::setProgressInterval(int milliseconds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    progress_interval_ms = milliseconds < 0 ? 0 : milliseconds;
+}
+
+std::shared_ptr<RenderJob> RenderManager::prepare(const RenderOptions& options,
+                                                  std::vector<MathEquation> equations) {
+    auto job = std::make_shared<RenderJob>();
+    job->options = options;
+    job->equations = std::move(equations);
+    // Nothing after the range changes its frames
+    int last = job->options.last_animation;
+    if (last >= 0 && static_cast<size_t>(last) + 1 < job->equations.size()) {
+        job->equations.erase(job->equations.begin() + last + 1, job->equations.end());
+    }
+    int count = static_cast<int>(job->equations.size());
+    job->options.first_animation = std::clamp(job->options.first_animation, 0, std::max(count - 1, 0));
+    job->options.last_animation = count - 1;
+    return job;
+}
+
+void RenderManager::plan(const std::shared_ptr<RenderJob>& job, const AssetGraph& graph, bool started) {
+    RenderOptions options;
+    bool estimated;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        options = job->options;
+        estimated = job->planned;
+    }
+    RenderWork work = graph.work(job->equations);
+    std::vector<AssetDecision> assets = graph.decisions();
+    double seconds = estimated ? 0.0 : render_estimator.estimate(options, work).seconds;
+
+    PlannedCallback callback;
+    bool report = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool queued = job->state == RenderState::Queued;
+        if (!queued && !started) return;
+        if (queued) queue.erase(queueKey(*job));
+        job->work = work;
+        job->assets = std::move(assets);
+        if (!job->planned) {
+            job->estimated_seconds = seconds;
+            job->planned = true;
+            callback = planned_callback;
+            report = true;
+        }
+        if (queued) {
+            queue.insert(queueKey(*job));
+            dispatchQueued();
+        }
+    }
+    if (!report) return;
+    std::cout << "[C++] Render job #" << job->id << " estimated to take ";
+    if (seconds < 0.0) std::cout << "an unknown time";
+    else std::cout << seconds << "s";
+    std::cout << std::endl;
+    if (callback) callback(job->id, seconds);
+}
+
+void RenderManager::planLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        planner_wake.wait(lock, [this] { return shutting_down || !unplanned.empty(); });
+        if (shutting_down) break;
+        auto it = jobs.find(unplanned.front());
+        unplanned.pop_front();
+        // A job that already started plans itself
+        if (it == jobs.end() || it->second->state != RenderState::Queued) continue;
+        std::shared_ptr<RenderJob> job = it->second;
+        RenderOptions options = job->options;
+
+        lock.unlock();
+        AssetGraph graph = planAssets(options, job->equations);
+        plan(job, graph, false);
+        lock.lock();
+    }
+}
+
+// Caller holds `mutex`
+void RenderManager::enqueue(const std::shared_ptr<RenderJob>& job) {
+    job->id = next_job_id++;
+    job->submitted_at = std::chrono::steady_clock::now();
+    jobs[job->id] = job;
+    queue.insert(queueKey(*job));
+    unplanned.push_back(job->id);
+    planner_wake.notify_one();
+
+    std::cout << "[C++] Render job #" << job->id << " queued with "
+              << job->equations.size() << " equations (priority "
+              << job->options.priority << ")" << std::endl;
+}
+
+std::tuple<int, long, int> RenderManager::queueKey(const RenderJob& job) {
+    // Shortest job first among previews, so a quick edit isn't stuck
+    // behind a long one; unknown estimates, and jobs not planned yet, go
+    // last. Other priorities stay
+    // first come, first served: their order is the user's, and a long
+    // export should not wait behind every short one.
+    long rank = 0;
+    if (job.options.priority >= RENDER_PRIORITY_PREVIEW) {
+        rank = job.estimated_seconds < 0.0 ? LONG_MAX : static_cast<long>(job.estimated_seconds * 1000.0);
+    }
+    return {-job.options.priority, rank, job.id};
+}
+
+AssetGraph RenderManager::planAssets(const RenderOptions& options, const std::vector<MathEquation>& equations) {
+    // Mirrors runJob's choice between the segmented and whole render
+    bool segmented = (segment_cache_enabled || render_parallelism > 1) && !options.still_frame && !equations.empty();
+    AssetGraph graph(options, equations, segmented);
+    // Only the warm worker reports where snippets land in Manim's tex cache
+    bool tex_tracked = worker_pool.enabled();
+    for (auto& node : graph.nodes) {
+        if (node.kind == AssetGraph::Kind::Tex && !tex_tracked) {
+            node.output = AssetGraph::Output::Untracked;
+        } else if (node.kind == AssetGraph::Kind::Segment) {
+            node.output = !segment_cache_enabled ? AssetGraph::Output::CacheOff
+                        : segment_cache.contains(node.hash) ? AssetGraph::Output::Present
+                        : AssetGraph::Output::Missing;
+        } else if (node.kind == AssetGraph::Kind::Video) {
+            node.output = !cache_enabled ? AssetGraph::Output::CacheOff
+                        : render_cache.contains(node.hash) ? AssetGraph::Output::Present
+                        : AssetGraph::Output::Missing;
+        }
+    }
+    graph.decide(asset_manifest);
+    return graph;
+}
+
+RenderEstimator::Estimate RenderManager::estimate(const RenderOptions& options, std::vector<MathEquation> equations,
+                                                  RenderWork& work) {
+    auto job = prepare(options, std::move(equations));
+    work = planAssets(job->options, job->equations).work(job->equations);
+    return render_estimator.estimate(job->options, work);
+}
+
+std::vector<AssetDecision> RenderManager::explain(const RenderOptions& options,
+                                                  std::vector<MathEquation> equations) {
+    auto job = prepare(options, std::move(equations));
+    return planAssets(job->options, job->equations).decisions();
+}
+
+int RenderManager::submit(const RenderOptions& options, std::vector<MathEquation> equations) {
+    auto job = prepare(options, std::move(equations));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    reapFinishedWorkers();
+
+    enqueue(job);
+    dispatchQueued();
+    return job->id;
+}
+
+std::pair<int, int> RenderManager::submitProgressive(const RenderOptions& options,
+                                                     std::vector<MathEquation> equations) {
+    RenderOptions draft_options = options;
+    draft_options.quality = "-ql";
+    RenderOptions final_options = options;
+    final_options.quality = "-qh";
+    final_options.priority = RENDER_PRIORITY_BACKGROUND;
+
+    auto draft = prepare(draft_options, equations);
+    auto final_job = prepare(final_options, std::move(equations));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    reapFinishedWorkers();
+
+    enqueue(draft);
+    enqueue(final_job);
+    // Waiting for the draft means its TeX output (media/Tex, shared by
+    // every quality) is complete before the final render looks for it
+    final_job->depends_on = draft->id;
+    draft->upgrade_job = final_job->id;
+    dispatchQueued();
+    return {draft->id, final_job->id};
+}
+
+// Caller holds `mutex`
+void RenderManager::dispatchQueued() {
+    auto it = queue.begin();
+    while (!shutting_down && running_jobs < max_concurrent && it != queue.end()) {
+        int id = std::get<2>(*it);
+        std::shared_ptr<RenderJob> job = jobs[id];
+
+        auto dependency = jobs.find(job->depends_on);
+        if (dependency != jobs.end() &&
+            (dependency->second->state == RenderState::Queued ||
+             dependency->second->state == RenderState::Running)) {
+            ++it;
+            continue;
+        }
+        it = queue.erase(it);
+
+        job->state = RenderState::Running;
+        job->started_at = std::chrono::steady_clock::now();
+        running_jobs++;
+        workers.emplace(id, std::thread(&RenderManager::runJob, this, job));
+        std::cout << "[C++] Render job #" << id << " started" << std::endl;
+    }
+}
+
+void RenderManager::setMaxConcurrent(int count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    max_concurrent = count < 1 ? 1 : count;
+    dispatchQueued();
+}
+
+int RenderManager::maxConcurrent() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return max_concurrent;
+}
+
+bool RenderManager::reprioritize(int id, int priority) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end()) return false;
+
+    auto& job = it->second;
+    if (job->state == RenderState::Queued) {
+        queue.erase(queueKey(*job));
+        job->options.priority = priority;
+        queue.insert(queueKey(*job));
+        return true;
+    }
+    if (job->state != RenderState::Running) return false;
+    job->options.priority = priority;
+    return true;
+}
+
+std::vector<RenderJob> RenderManager::queueSnapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<RenderJob> snapshot;
+    for (const auto& [id, job] : jobs) {
+        if (job->state == RenderState::Running) snapshot.push_back(*job);
+    }
+    for (const auto& [priority, rank, id] : queue) {
+        snapshot.push_back(*jobs.at(id));
+    }
+    return snapshot;
+}
+
+bool RenderManager::getJob(int id, RenderJob& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end()) return false;
+    out = *it->second;
+    return true;
+}
+
+int RenderManager::activeJobCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    int count = 0;
+    for (const auto& [id, job] : jobs) {
+        if (job->state == RenderState::Running || job->state == RenderState::Queued) count++;
+    }
+    return count;
+}
+
+void RenderManager::setLimits(const Limits& new_limits) {
+    std::lock_guard<std::mutex> lock(mutex);
+    limits.wall_seconds = std::max(0.0, new_limits.wall_seconds);
+    limits.memory_kb = std::max(0L, new_limits.memory_kb);
+}
+
+RenderManager::Limits RenderManager::getLimits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return limits;
+}
+
+void RenderManager::monitorLoop() {
+    using Clock = std::chrono::steady_clock;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!shutting_down) {
+        monitor_wake.wait_for(lock, std::chrono::milliseconds(monitor_interval_ms));
+        if (shutting_down) break;
+
+        std::vector<std::shared_ptr<RenderJob>> running;
+        std::set<pid_t> groups;
+        for (const auto& [id, job] : jobs) {
+            if (job->state != RenderState::Running) continue;
+            running.push_back(job);
+            groups.insert(job->process_groups.begin(), job->process_groups.end());
+        }
+        if (running.empty()) continue;
+
+        // Walking /proc takes a while with many processes; don't hold up
+        // the workers meanwhile
+        lock.unlock();
+        std::map<pid_t, ProcessSample> samples = sampleProcessGroups(groups);
+        Clock::time_point now = Clock::now();
+        lock.lock();
+
+        for (const auto& job : running) {
+            if (job->state != RenderState::Running) continue;
+            ProcessSample total;
+            for (int process_group : job->process_groups) {
+                auto it = samples.find(process_group);
+                if (it == samples.end()) continue;
+                total.processes += it->second.processes;
+                total.cpu_seconds += it->second.cpu_seconds;
+                total.rss_kb += it->second.rss_kb;
+                total.read_bytes += it->second.read_bytes;
+                total.write_bytes += it->second.write_bytes;
+            }
+
+            RenderResources& resources = job->resources;
+            double interval = resources.sampled_at == Clock::time_point()
+                ? 0.0 : std::chrono::duration<double>(now - resources.sampled_at).count();
+            // A process that exited takes its CPU time out of the sum
+            resources.cpu_percent = interval > 0.0
+                ? std::max(0.0, (total.cpu_seconds - resources.cpu_seconds) / interval * 100.0) : 0.0;
+            resources.processes = total.processes;
+            resources.cpu_seconds = total.cpu_seconds;
+            resources.rss_kb = total.rss_kb;
+            resources.peak_rss_kb = std::max(resources.peak_rss_kb, total.rss_kb);
+            resources.read_bytes = total.read_bytes;
+            resources.write_bytes = total.write_bytes;
+            resources.sampled_at = now;
+
+            if (job->cancel_requested) continue;
+            char reason[160] = "";
+            double wall = std::chrono::duration<double>(now - job->started_at).count();
+            if (limits.wall_seconds > 0.0 && wall > limits.wall_seconds) {
+                snprintf(reason, sizeof(reason), "ran longer than the %.0f s time limit", limits.wall_seconds);
+            } else if (limits.memory_kb > 0 && total.rss_kb > limits.memory_kb) {
+                snprintf(reason, sizeof(reason), "used %ld MB, over the %ld MB memory limit",
+                         total.rss_kb / 1024, limits.memory_kb / 1024);
+            }
+            if (!reason[0]) continue;
+
+            // Same path as a cancel: SIGTERM now, SIGKILL after the grace
+            // period, and the worker reports it as failed with the reason
+            job->stop_reason = reason;
+            job->cancel_requested = true;
+            for (int process_group : job->process_groups) {
+                kill(-process_group, SIGTERM);
+            }
+            std::cerr << "[C++] Stopping render job #" << job->id << ": " << reason << std::endl;
+        }
+    }
+}
+
+void RenderManager::setWorkerScript(const std::string& path) {
+    worker_pool.setWorkerScript(path);
+}
+
+void RenderManager::setRenderParallelism(int processes) {
+    render_parallelism = processes < 1 ? 1 : processes;
+}
+
+void RenderManager::shutdown() {
+    std::vector<int> active;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Nothing new may start once we begin cancelling
+        shutting_down = true;
+        for (const auto& [id, job] : jobs) {
+            if (job->state == RenderState::Running || job->state == RenderState::Queued) {
+                active.push_back(id);
+            }
+        }
+    }
+    for (int id : active) cancel(id);
+
+    // Workers exit within the cancel grace period plus one poll interval
+    std::map<int, std::thread> running;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running.swap(workers);
+        finished_workers.clear();
+    }
+    for (auto& [id, worker] : running) {
+        if (worker.joinable()) worker.join();
+    }
+    monitor_wake.notify_all();
+    if (monitor_thread.joinable()) monitor_thread.join();
+    planner_wake.notify_all();
+    if (planner_thread.joinable()) planner_thread.join();
+    worker_pool.shutdown();
+}
+
+void RenderManager::finishStopped(const std::shared_ptr<RenderJob>& job) {
+    std::string reason;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        reason = job->stop_reason;
+    }
+    if (reason.empty()) finishJob(job, RenderState::Cancelled, "Render cancelled");
+    else finishJob(job, RenderState::Failed, "✗ Render stopped: " + reason);
+}
+
+// Caller holds `mutex`
+void RenderManager::reapFinishedWorkers() {
+    for (int id : finished_workers) {
+        auto it = workers.find(id);
+        if (it == workers.end()) continue;
+        if (it->second.joinable()) it->second.join();
+        workers.erase(it);
+    }
+    finished_workers.clear();
+}
+
+void RenderManager::finishJob(const std::shared_ptr<RenderJob>& job, RenderState state,
+                              const std::string& message) {
+    RenderJob snapshot;
+    FinishedCallback callback;
+    std::shared_ptr<RenderJob> dropped_upgrade;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool was_running = job->state == RenderState::Running;
+
+        // A draft that failed or was cancelled takes its high quality
+        // version with it: that would fail the same way or is not wanted.
+        // It is still waiting on the draft, so it never started.
+        auto upgrade = jobs.find(job->upgrade_job);
+        if (state != RenderState::Succeeded && upgrade != jobs.end() &&
+            upgrade->second->state == RenderState::Queued) {
+            dropped_upgrade = upgrade->second;
+            queue.erase(queueKey(*dropped_upgrade));
+            dropped_upgrade->cancel_requested = true;
+        }
+
+        job->state = state;
+        job->message = message;
+        job->finished_at = std::chrono::steady_clock::now();
+        snapshot = *job;
+        callback = finished_callback;
+        if (was_running) {
+            finished_workers.push_back(job->id);
+            running_jobs--;
+            dispatchQueued();
+        }
+    }
+    if (callback) callback(snapshot);
+    render_telemetry.record(snapshot);
+
+    if (dropped_upgrade) {
+        finishJob(dropped_upgrade, RenderState::Cancelled,
+                  std::string("Render cancelled: draft ") + renderStateName(state));
+    }
+}
+
+void RenderManager::reportProgress(const std::shared_ptr<RenderJob>& job,
+                                   const RenderProgress& progress) {
+    ProgressCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job->progress = progress;
+        callback = progress_callback;
+    }
+    if (callback) callback(job->id, progress);
+}
+
+bool RenderManager::ParallelProgress::update(size_t run, const RenderProgress& progress,
+                                            RenderProgress& combined) {
+    std::lock_guard<std::mutex> lock(mutex);
+    runs[run] = progress;
+
+    // Every run reports its own bar; throttle the merged one as a whole
+    // rather than letting N processes multiply the update rate
+    auto now = std::chrono::steady_clock::now();
+    bool run_finished = progress.animation + 1 >= progress.animation_count &&
+                        progress.frame >= progress.frame_count;
+    if (!run_finished && now - last_report < interval) return false;
+    last_report = now;
+
+    combined = progress;
+    combined.animation = 0;
+    combined.animation_count = animation_count;
+    combined.total_frames = 0;
+    combined.fps = 0.0;
+    double done = 0.0;
+    for (const auto& p : runs) {
+        // Animations finished so far; `animation` is the one in progress
+        combined.animation += p.percent >= 100.0 ? p.animation_count : p.animation;
+        combined.total_frames += p.total_frames;
+        combined.fps += p.fps;
+        done += p.percent * p.animation_count;
+    }
+    combined.percent = animation_count > 0 ? done / animation_count : 0.0;
+    combined.animation = std::min(combined.animation, animation_count - 1);
+    return true;
+}
+
+namespace {
+
+bool writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += n;
+    }
+    return true;
+}
+
+}
+
+bool RenderManager::cancel(int id) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = jobs.find(id);
+    if (it == jobs.end()) return false;
+
+    auto job = it->second;
+    if (job->state == RenderState::Queued) {
+        // Never started, so there is nothing to kill or clean up
+        queue.erase(queueKey(*job));
+        job->cancel_requested = true;
+        lock.unlock();
+        std::cout << "[C++] Removed render job #" << id << " from the queue" << std::endl;
+        finishJob(job, RenderState::Cancelled, "Render cancelled");
+        return true;
+    }
+    if (job->state != RenderState::Running) return false;
+
+    if (job->cancel_requested) return true;
+    job->cancel_requested = true;
+
+    // The worker notices the flag before spawning, or escalates to
+    // SIGKILL itself once the grace period has passed
+    for (int process_group : job->process_groups) {
+        kill(-process_group, SIGTERM);
+    }
+    std::cout << "[C++] Cancelling render job #" << id << std::endl;
+    return true;
+}
+
+void RenderManager::recordUsage(const std::shared_ptr<RenderJob>& job, const std::string& program,
+                                int status, const ProcessUsage& usage) {
+    ProcessResult result;
+    result.status = status;
+    result.usage = usage;
+    std::cout << "[C++] Job #" << job->id << " " << program << " finished: " << result.describe() << std::endl;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    job->usage.user_seconds += usage.user_seconds;
+    job->usage.system_seconds += usage.system_seconds;
+    job->usage.max_rss_kb = std::max(job->usage.max_rss_kb, usage.max_rss_kb);
+    if (WIFEXITED(status) && WEXITSTATUS(status) != 0) job->exit_status = WEXITSTATUS(status);
+    else if (WIFSIGNALED(status)) job->exit_status = 128 + WTERMSIG(status);
+}
+
+void RenderManager::addStageTime(const std::shared_ptr<RenderJob>& job, const char* stage,
+                                 std::chrono::steady_clock::time_point start) {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : job->stage_seconds) {
+        if (entry.first == stage) {
+            entry.second += seconds;
+            return;
+        }
+    }
+    job->stage_seconds.emplace_back(stage, seconds);
+}
+
+void RenderManager::timeAnimations(const std::shared_ptr<RenderJob>& job, const std::string& video_path,
+                                    const std::vector<std::string>& clips) {
+    double length = mp4Duration(video_path);
+    std::vector<double> starts;
+    double at = 0.0;
+    for (const auto& clip : clips) {
+        double clip_length = mp4Duration(clip);
+        if (clip_length < 0.0) {
+            starts.clear();
+            break;
+        }
+        starts.push_back(at);
+        at += clip_length;
+    }
+    // A whole-scene render has no boundaries to go by; spread the
+    // animations evenly over the video
+    size_t count = job->equations.size() - std::min<size_t>(job->options.first_animation, job->equations.size());
+    if (starts.empty() && count > 0 && length > 0.0) {
+        for (size_t i = 0; i < count; i++) starts.push_back(length * i / count);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    job->video_seconds = std::max(length, 0.0);
+    job->animation_starts = std::move(starts);
+}
+
+bool RenderManager::cancelRequested(const std::shared_ptr<RenderJob>& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return job->cancel_requested;
+}
+
+RenderManager::RunResult RenderManager::pumpProcess(const std::shared_ptr<RenderJob>& job,
+                                                    const ChildProcess& child,
+                                                    const OutputHandler& on_output) {
+    using Clock = std::chrono::steady_clock;
+    int grace_ms;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job->process_groups.insert(child.pid);
+        grace_ms = cancel_grace_ms;
+    }
+
+    // Read with read(2) rather than fgets: Manim's progress bars are
+    // redrawn with '\r' and would otherwise sit in the buffer until a
+    // newline. poll() services stdout and stderr together, so neither
+    // pipe fills up and blocks the child, and keeps the loop waking up so
+    // a cancel can escalate even when the process tree has gone silent.
+    std::array<char, 4096> buffer;
+    Clock::time_point kill_deadline;
+    bool cancelling = false;
+    bool killed = false;
+    pollfd fds[2] = {{child.out_fd, POLLIN, 0}, {child.err_fd, POLLIN, 0}};
+    const int streams[2] = {STDOUT_FILENO, STDERR_FILENO};
+    int open_streams = 2;
+    bool stopped = false;
+
+    while (open_streams > 0 && !stopped) {
+        if (!cancelling && cancelRequested(job)) {
+            cancelling = true;
+            kill_deadline = Clock::now() + std::chrono::milliseconds(grace_ms);
+        }
+        if (cancelling && !killed && Clock::now() >= kill_deadline) {
+            kill(-child.pid, SIGKILL);
+            killed = true;
+        }
+
+        int ready = poll(fds, 2, 200);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (ready == 0) continue;
+
+        for (int i = 0; i < 2 && !stopped; i++) {
+            if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t n = read(fds[i].fd, buffer.data(), buffer.size());
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                fds[i].fd = -1;
+                open_streams--;
+                continue;
+            }
+            stopped = on_output(streams[i], buffer.data(), static_cast<size_t>(n));
+        }
+    }
+
+    // A warm worker flushes stderr before it prints its done marker, so
+    // the rest of this request's stderr is already in the pipe
+    if (stopped && fds[1].fd >= 0) {
+        OutputRing rest(buffer.size());
+        drainReadable(fds[1].fd, &rest);
+        std::string tail = rest.str();
+        if (!tail.empty()) on_output(STDERR_FILENO, tail.data(), tail.size());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    job->process_groups.erase(child.pid);
+    return job->cancel_requested ? RunResult::Cancelled : RunResult::Succeeded;
+}
+
+RenderManager::RunResult RenderManager::runManim(const std::shared_ptr<RenderJob>& job, ManimRun& run) {
+    // Hand the scene to a warm worker when one is configured, otherwise
+    // run `python -m manim` for this script
+    std::unique_ptr<ManimWorker> worker;
+    ChildProcess child;
+    int interval_ms;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (job->cancel_requested) return RunResult::Cancelled;
+        if (worker_pool.enabled()) {
+            worker = worker_pool.acquire();
+            child = worker->process;
+        } else {
+            std::vector<std::string> argv = {"python", "-m", "manim", run.script_path, job->options.quality};
+            if (job->options.still_frame) argv.push_back("-s");
+            if (job->options.width > 0 && job->options.height > 0) {
+                argv.push_back("-r");
+                argv.push_back(std::to_string(job->options.width) + "," + std::to_string(job->options.height));
+            }
+            argv.insert(argv.end(), run.scenes.begin(), run.scenes.end());
+            std::cout << "[C++] Job #" << job->id << " executing: " << commandLine(argv) << std::endl;
+            child = spawnProcessGroup(argv);
+        }
+        job->process_groups.insert(child.pid);
+        interval_ms = progress_interval_ms;
+    }
+    pid_t pid = child.pid;
+    bool warm = worker != nullptr;
+
+    if (warm) {
+        std::string scenes;
+        for (const auto& scene : run.scenes) {
+            scenes += (scenes.empty() ? "" : ", ") + jsonQuote(scene);
+        }
+        std::string tex;
+        for (const auto& snippet : run.tex) {
+            tex += (tex.empty() ? "" : ", ") + jsonQuote(snippet);
+        }
+        std::string request = "{\"job\": " + std::to_string(job->id) +
+                              ", \"script\": " + jsonQuote(run.script_path) +
+                              ", \"scenes\": [" + scenes + "]" +
+                              (tex.empty() ? "" : ", \"tex\": [" + tex + "]") +
+                              ", \"quality\": " + jsonQuote(job->options.quality);
+        if (job->options.still_frame) request += ", \"still\": true";
+        if (job->options.width > 0 && job->options.height > 0) {
+            request += ", \"resolution\": [" + std::to_string(job->options.width) + ", " +
+                       std::to_string(job->options.height) + "]";
+        }
+        request += "}\n";
+        std::cout << "[C++] Job #" << job->id << " sent to Manim worker " << pid << std::endl;
+        if (!writeAll(child.in_fd, request)) {
+            // Worker died between renders; the read below sees EOF and
+            // the job fails like any other crash
+            std::cerr << "[C++] Job #" << job->id << " could not reach Manim worker" << std::endl;
+        }
+    }
+
+    using Clock = std::chrono::steady_clock;
+    ManimProgressParser parser;
+    RenderProgress progress;
+    progress.animation_count = run.animation_count;
+    Clock::time_point first_frame_time;
+    Clock::time_point last_report;
+    int last_reported_animation = -1;
+    std::string done_marker = std::string(MANIM_WORKER_DONE) + " ";
+    std::string scene_marker = std::string(MANIM_WORKER_SCENE) + " ";
+    size_t scenes_written = 0;
+    std::string worker_reply;  // JSON after the done marker
+    std::string stdout_line;   // partial stdout line, for the done marker
+    std::string ready_scan;    // stdout not yet searched for "File ready at"
+
+    RunResult pumped = pumpProcess(job, child, [&](int stream, const char* data, size_t n) {
+        run.output.append(data, n);
+
+        // Manim logs to stdout and draws its progress bars on stderr
+        if (stream == STDOUT_FILENO) {
+            if (warm) {
+                // A warm worker stays alive, so the end of this request's
+                // output is its done marker line rather than EOF
+                for (size_t i = 0; i < n && worker_reply.empty(); i++) {
+                    if (data[i] != '\n') {
+                        if (stdout_line.size() < 64 * 1024) stdout_line += data[i];
+                        continue;
+                    }
+                    if (stdout_line.compare(0, done_marker.size(), done_marker) == 0) {
+                        worker_reply = stdout_line.substr(done_marker.size());
+                    } else if (stdout_line.compare(0, scene_marker.size(), scene_marker) == 0 && run.on_video) {
+                        run.on_video(scenes_written++, jsonField(stdout_line.substr(scene_marker.size()), "video"));
+                    }
+                    stdout_line.clear();
+                }
+            } else {
+                ready_scan.append(data, n);
+                takeVideoPaths(ready_scan, run.videos);
+                while (run.on_video && scenes_written < run.videos.size()) {
+                    run.on_video(scenes_written, run.videos[scenes_written]);
+                    scenes_written++;
+                }
+            }
+            return !worker_reply.empty();
+        }
+
+        bool finished = !worker_reply.empty();
+        bool updated = parser.feed(data, n);
+        if (!updated) return finished;
+
+        Clock::time_point now = Clock::now();
+        if (last_reported_animation < 0) first_frame_time = now;
+
+        // Cap the update rate, but never drop the first report for a
+        // new animation so the bar doesn't skip steps on short plays.
+        bool new_animation = parser.animation() != last_reported_animation;
+        if (!finished && !new_animation &&
+            now - last_report < std::chrono::milliseconds(interval_ms)) {
+            return false;
+        }
+
+        parser.fill(progress);
+        double elapsed = std::chrono::duration<double>(now - first_frame_time).count();
+        progress.fps = elapsed > 0.0 ? progress.total_frames / elapsed : 0.0;
+        last_report = now;
+        last_reported_animation = parser.animation();
+        if (run.on_progress) run.on_progress(progress);
+        else reportProgress(job, progress);
+        return finished;
+    });
+    bool cancelled = pumped == RunResult::Cancelled;
+
+    bool succeeded = false;
+    if (warm) {
+        if (!cancelled && !worker_reply.empty()) {
+            succeeded = jsonField(worker_reply, "ok") == "true";
+            run.videos = jsonStringArray(worker_reply, "videos");
+            run.error = jsonField(worker_reply, "error");
+            run.reply = worker_reply;
+            worker_pool.release(std::move(worker));
+        } else {
+            if (!cancelled) {
+                std::cerr << "[C++] Job #" << job->id << " Manim worker " << pid
+                          << " exited unexpectedly, restarting it" << std::endl;
+                run.error = "Manim worker exited unexpectedly";
+            }
+            worker_pool.discard(std::move(worker));
+        }
+    } else {
+        ProcessUsage usage;
+        run.status = waitProcess(child, &usage);
+        recordUsage(job, "manim", run.status, usage);
+        if (!cancelled && WIFEXITED(run.status) && WEXITSTATUS(run.status) == 0 && !run.videos.empty()) {
+            succeeded = true;
+        } else {
+            run.error = run.output.str();
+        }
+    }
+
+    if (cancelled) {
+        // Sweep up anything in the group that outlived Manim itself
+        kill(-pid, SIGKILL);
+        return RunResult::Cancelled;
+    }
+    if (succeeded && run.videos.size() != run.scenes.size()) {
+        succeeded = false;
+        run.error = "Manim reported " + std::to_string(run.videos.size()) + " videos for " +
+                    std::to_string(run.scenes.size()) + " scenes";
+    }
+    return succeeded ? RunResult::Succeeded : RunResult::Failed;
+}
+
+RenderManager::RunResult RenderManager::runTool(const std::shared_ptr<RenderJob>& job,
+                                                const std::vector<std::string>& argv, OutputRing& output) {
+    ChildProcess child;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (job->cancel_requested) return RunResult::Cancelled;
+        std::cout << "[C++] Job #" << job->id << " executing: " << commandLine(argv) << std::endl;
+        child = spawnProcessGroup(argv);
+        job->process_groups.insert(child.pid);
+    }
+    pid_t pid = child.pid;
+
+    RunResult pumped = pumpProcess(job, child, [&](int, const char* data, size_t n) {
+        output.append(data, n);
+        return false;
+    });
+    ProcessUsage usage;
+    int status = waitProcess(child, &usage);
+    recordUsage(job, argv[0], status, usage);
+
+    if (pumped == RunResult::Cancelled) {
+        kill(-pid, SIGKILL);
+        return RunResult::Cancelled;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? RunResult::Succeeded : RunResult::Failed;
+}
+
+RenderManager::RunResult RenderManager::precompileTex(const std::shared_ptr<RenderJob>& job,
+                                                      const std::vector<std::string>& snippets) {
+    // Only the warm worker knows Manim's TeX template, which the tex cache
+    // file names are hashed from
+    if (!worker_pool.enabled() || snippets.empty()) return RunResult::Succeeded;
+
+    ManimRun run;
+    run.script_path = job->script_path;
+    run.tex = snippets;
+
+    auto start = std::chrono::steady_clock::now();
+    RunResult result = runManim(job, run);
+    addStageTime(job, "tex", start);
+    if (result == RunResult::Succeeded) {
+        std::cout << "[C++] Job #" << job->id << " compiled " << jsonField(run.reply, "tex_compiled")
+                  << " of " << run.tex.size() << " LaTeX snippets in one TeX run" << std::endl;
+        // Where each snippet lives in Manim's tex cache, typeset now or
+        // before, so the asset graph can tell whether it is still there
+        std::vector<std::string> files = jsonStringArray(run.reply, "tex_files");
+        for (size_t i = 0; i < files.size() && i < run.tex.size(); i++) {
+            if (!files[i].empty()) AssetGraph::recordTex(asset_manifest, run.tex[i], files[i]);
+        }
+    } else if (result == RunResult::Failed) {
+        // Not fatal: Manim compiles whatever is missing itself and reports
+        // the offending equation on its own
+        std::cerr << "[C++] Job #" << job->id << " batch LaTeX compile failed, "
+                  << "leaving it to Manim: " << run.error.substr(0, 200) << std::endl;
+    }
+    return result;
+}
+
+RenderManager::RunResult RenderManager::renderWhole(const std::shared_ptr<RenderJob>& job,
+                                                    const AssetGraph& graph, const std::string& scene_data,
+                                                    std::string& video_path, std::string& error) {
+    auto start = std::chrono::steady_clock::now();
+    ManimScript::write(job->script_path, scene_data, scene_runner_dir);
+    addStageTime(job, "script", start);
+    if (precompileTex(job, graph.texSnippets(job->equations.size())) == RunResult::Cancelled) {
+        return RunResult::Cancelled;
+    }
+
+    ManimRun run;
+    run.script_path = job->script_path;
+    run.scenes = {"GeneratedScene"};
+    run.animation_count = ManimScript::animationCount(job->equations, job->options.first_animation);
+
+    start = std::chrono::steady_clock::now();
+    RunResult result = runManim(job, run);
+    addStageTime(job, "animation", start);
+    if (result == RunResult::Succeeded) {
+        video_path = run.videos.back();
+    } else {
+        error = run.error;
+    }
+    return result;
+}
+
+RenderManager::RunResult RenderManager::renderSegmented(const std::shared_ptr<RenderJob>& job,
+                                                        const AssetGraph& graph,
+                                                        std::string& video_path, std::string& error) {
+    const auto& equations = job->equations;
+    // A range render is just the segments in the range; each one sets up
+    // the equations before it without animating them anyway
+    int first = job->options.first_animation;
+    int count = static_cast<int>(equations.size()) - first;
+
+    // Only the segments the graph rebuilds render; a cached one can still
+    // have been evicted since it was planned. `keys` and `clips` are
+    // indexed from the start of the range.
+    bool use_cache = segment_cache_enabled;
+    std::vector<std::string> keys(count);
+    std::vector<std::string> clips(count);
+    std::vector<int> missing;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        const AssetGraph::Node* node = graph.find(AssetGraph::Kind::Segment, first + i);
+        keys[i] = node->hash;
+        if (node->rebuild || !segment_cache.lookup(keys[i], clips[i])) missing.push_back(i);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job->segments_total = count;
+        job->segments_rendered = static_cast<int>(missing.size());
+    }
+    addStageTime(job, "cache", start);
+
+    // Hand clips on in scene order as soon as every clip before them
+    // exists, so the preview can start on the first segments while later
+    // ones are still rendering
+    SegmentCallback on_segment;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        on_segment = segment_callback;
+    }
+    std::mutex stream_mutex;
+    int streamed = 0;
+    auto clipReady = [&](int index, const std::string& clip) {
+        std::lock_guard<std::mutex> lock(stream_mutex);
+        if (index >= 0) clips[index] = clip;
+        while (streamed < count && !clips[streamed].empty()) {
+            if (on_segment) on_segment(job->id, streamed, count, clips[streamed]);
+            streamed++;
+        }
+    };
+    clipReady(-1, "");
+
+    if (!missing.empty()) {
+        std::vector<int> segments;
+        for (int i : missing) segments.push_back(first + i);
+        start = std::chrono::steady_clock::now();
+        ManimScript::write(job->script_path, ManimScript::segments(equations, segments), scene_runner_dir);
+        addStageTime(job, "script", start);
+
+        // Compile the LaTeX once up front instead of in every process;
+        // segment i typesets equations 0..i. The worker skips whatever is
+        // already in Manim's tex cache.
+        if (precompileTex(job, graph.texSnippets(segments.back() + 1)) == RunResult::Cancelled) {
+            return RunResult::Cancelled;
+        }
+
+        // `render_parallelism` Manim processes are shared by all running
+        // jobs, each taking at most an equal share and at least one, so
+        // concurrent renders don't start cores² Pythons
+        size_t processes;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            int share = std::max(1, render_parallelism / std::max(running_jobs, 1));
+            int spare = std::max(0, render_parallelism - running_jobs - extra_processes);
+            processes = std::min<size_t>({missing.size(), static_cast<size_t>(share), static_cast<size_t>(spare) + 1});
+            extra_processes += static_cast<int>(processes) - 1;
+        }
+
+        // Deal the segments out round robin, so every process gets a mix
+        // of early (cheap) and late (busier) segments
+        std::vector<ManimRun> runs(processes);
+        for (size_t k = 0; k < missing.size(); k++) {
+            ManimRun& run = runs[k % processes];
+            run.scenes.push_back(ManimScript::segmentClassName(segments[k]));
+        }
+        std::cout << "[C++] Job #" << job->id << " rendering " << missing.size() << " of "
+                  << count << " segments in " << processes << " process(es)" << std::endl;
+
+        ParallelProgress merged;
+        merged.runs.resize(processes);
+        merged.animation_count = static_cast<int>(missing.size()) * ManimScript::ANIMATIONS_PER_SEGMENT;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            merged.interval = std::chrono::milliseconds(progress_interval_ms);
+        }
+
+        std::vector<RunResult> results(processes, RunResult::Failed);
+        auto render = [&](size_t r) {
+            ManimRun& run = runs[r];
+            run.script_path = job->script_path;
+            run.animation_count = static_cast<int>(run.scenes.size()) * ManimScript::ANIMATIONS_PER_SEGMENT;
+            if (processes > 1) {
+                run.on_progress = [&, r](const RenderProgress& progress) {
+                    RenderProgress combined;
+                    if (merged.update(r, progress, combined)) reportProgress(job, combined);
+                };
+            }
+            run.on_video = [&, r](size_t k, const std::string& video) {
+                if (k >= runs[r].scenes.size() || video.empty()) return;
+                int index = missing[r + k * processes];
+                std::string cached = use_cache ? segment_cache.store(keys[index], video) : "";
+                clipReady(index, cached.empty() ? video : cached);
+            };
+            try {
+                results[r] = runManim(job, run);
+            } catch (const std::exception& e) {
+                run.error = e.what();
+            }
+        };
+
+        start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t r = 1; r < processes; r++) threads.emplace_back(render, r);
+        render(0);
+        for (auto& thread : threads) thread.join();
+        addStageTime(job, "animation", start);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            extra_processes -= static_cast<int>(processes) - 1;
+        }
+
+        // Clips were cached as they were written, so whatever rendered is
+        // kept even if a sibling process failed and a retry only redoes the
+        // segments that are still missing. Pick up any the run's output
+        // did not announce.
+        RunResult result = RunResult::Succeeded;
+        start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < processes; r++) {
+            if (results[r] == RunResult::Succeeded) {
+                for (size_t k = 0; k < runs[r].scenes.size(); k++) {
+                    int index = missing[r + k * processes];
+                    if (!clips[index].empty()) continue;
+                    std::string cached = use_cache ? segment_cache.store(keys[index], runs[r].videos[k]) : "";
+                    clipReady(index, cached.empty() ? runs[r].videos[k] : cached);
+                }
+            } else if (result != RunResult::Cancelled) {
+                result = results[r];
+                if (error.empty()) error = runs[r].error;
+            }
+        }
+        addStageTime(job, "cache", start);
+        if (result != RunResult::Succeeded) return result;
+    }
+
+    // Join the clips into the scene's video without re-encoding
+    std::filesystem::path output_dir = std::filesystem::path("media") / "videos" /
+                                       std::filesystem::path(job->script_path).stem();
+    std::filesystem::create_directories(output_dir);
+    std::filesystem::path output = output_dir / "GeneratedScene.mp4";
+
+    start = std::chrono::steady_clock::now();
+    RunResult result = concatClips(job, clips, output.string(), error);
+    addStageTime(job, "concat", start);
+    if (result == RunResult::Succeeded) {
+        video_path = std::filesystem::absolute(output).string();
+        timeAnimations(job, video_path, clips);
+    }
+    return result;
+}
+
+RenderManager::RunResult RenderManager::concatClips(const std::shared_ptr<RenderJob>& job,
+                                                    const std::vector<std::string>& clips,
+                                                    const std::string& output, std::string& error) {
+    // ffmpeg's concat demuxer reads the clip list from a file
+    std::string list_path = output + ".txt";
+    {
+        std::ofstream list(list_path);
+        for (const auto& clip : clips) {
+            std::string path = std::filesystem::absolute(clip).string();
+            std::string escaped;
+            for (char c : path) {
+                if (c == '\'') escaped += "'\\''";
+                else escaped += c;
+            }
+            list << "file '" << escaped << "'\n";
+        }
+        if (!list) {
+            error = "Could not write clip list " + list_path;
+            return RunResult::Failed;
+        }
+    }
+
+    OutputRing ffmpeg_output;
+    RunResult result = runTool(job, {"ffmpeg", "-y", "-loglevel", "error", "-f", "concat", "-safe", "0",
+                                     "-i", list_path, "-c", "copy", output}, ffmpeg_output);
+
+    std::error_code ec;
+    std::filesystem::remove(list_path, ec);
+    if (result == RunResult::Failed) error = "ffmpeg concat failed: " + ffmpeg_output.str();
+    return result;
+}
+
+void RenderManager::runJob(std::shared_ptr<RenderJob> job) {
+    try {
+        // 1. Generate the Manim Python script. Each job gets its own file so
+        //    concurrent renders don't overwrite each other's scene.
+        std::string script_path = scriptPath(job->options, job->id);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job->script_path = script_path;
+        }
+        std::cout << "[C++] Job #" << job->id << " generating script: " << script_path << std::endl;
+        bool still = job->options.still_frame;
+        // Plan again: renders that finished while this one waited may have
+        // filled the caches it was planned against
+        AssetGraph graph = planAssets(job->options, job->equations);
+        plan(job, graph, true);
+        for (const auto& node : graph.nodes) {
+            if (node.rebuild) std::cout << "[C++] Job #" << job->id << " rebuilds " << node.name << ": " << node.reason << std::endl;
+        }
+        std::cout << "[C++] Adding " << job->equations.size() << " equations to scene data" << std::endl;
+        auto start = std::chrono::steady_clock::now();
+        std::string scene_data = still ? ManimScript::still(job->equations)
+                                       : ManimScript::scene(job->equations, job->options.first_animation);
+        addStageTime(job, "script", start);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job->scene_bytes = scene_data.size();
+        }
+
+        // The scene data is the normalized form of the scene, so identical
+        // data at the same quality can reuse an earlier video as is.
+        // Stills are a single cheap frame and not videos, so they skip the
+        // caches and the segmented path. The video's graph node is named by
+        // the same key.
+        const AssetGraph::Node* video_node = graph.find(AssetGraph::Kind::Video);
+        std::string cache_key = video_node ? video_node->hash : "";
+        std::string cached_video;
+        bool use_cache = cache_enabled && !still;
+        start = std::chrono::steady_clock::now();
+        bool hit = use_cache && render_cache.lookup(cache_key, cached_video);
+        addStageTime(job, "cache", start);
+        if (hit) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job->cache_hit = true;
+                job->video_path = cached_video;
+                job->progress.percent = 100.0;
+            }
+            timeAnimations(job, cached_video, {});
+            graph.record(asset_manifest);
+            asset_manifest.save();
+            std::cout << "[C++] Job #" << job->id << " cache hit: " << cached_video << std::endl;
+            finishJob(job, RenderState::Succeeded, "✓ Video loaded from cache");
+            return;
+        }
+
+        // 2. Execute Manim, either per segment against the segment cache
+        //    or for the whole scene in one go
+        std::string video_path;
+        std::string error;
+        bool segmented = graph.find(AssetGraph::Kind::Segment, job->options.first_animation) != nullptr;
+        RunResult result = segmented ? renderSegmented(job, graph, video_path, error)
+                                     : renderWhole(job, graph, scene_data, video_path, error);
+
+        if (result == RunResult::Cancelled) {
+            removeJobOutput(script_path);
+            std::cout << "[C++] Job #" << job->id << " cancelled" << std::endl;
+            finishStopped(job);
+            return;
+        }
+
+        // Check if render was successful
+        if (result == RunResult::Succeeded) {
+            if (!still && !segmented) timeAnimations(job, video_path, {});
+            if (use_cache) {
+                start = std::chrono::steady_clock::now();
+                render_cache.store(cache_key, video_path);
+                addStageTime(job, "cache", start);
+            }
+            graph.record(asset_manifest);
+            asset_manifest.save();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job->video_path = video_path;
+            }
+            std::cout << "[C++] Job #" << job->id << " render successful! " << (still ? "Image: " : "Video: ")
+                      << video_path << std::endl;
+            finishJob(job, RenderState::Succeeded, still ? "✓ Preview rendered" : "✓ Video rendered successfully!");
+        } else {
+            std::cerr << "[C++] Job #" << job->id << " render failed:\n" << error << std::endl;
+            finishJob(job, RenderState::Failed, "✗ Render failed: " + error.substr(0, 100));
+        }
+
+    } catch (const std::exception& e) {
+        if (cancelRequested(job)) {
+            removeJobOutput(job->script_path);
+            finishStopped(job);
+            return;
+        }
+        std::cerr << "[C++] Exception during render job #" << job->id << ": " << e.what() << std::endl;
+        finishJob(job, RenderState::Failed, "✗ Error: " + std::string(e.what()));
+    }
+}
+
+bool RenderManager::readCheckOutput(const ChildProcess& child, std::string& output, OutputRing& errors,
+                                    const std::function<bool(const std::string&)>& done) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(check_timeout_ms);
+    std::array<char, 4096> buffer;
+    pollfd fds[2] = {{child.out_fd, POLLIN, 0}, {child.err_fd, POLLIN, 0}};
+    int open_streams = 2;
+    while (open_streams > 0 && !(done && done(output))) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+        if (remaining <= 0) return false;
+        int ready = poll(fds, 2, static_cast<int>(remaining));
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready < 0) break;
+        for (int i = 0; i < 2; i++) {
+            if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t n = read(fds[i].fd, buffer.data(), buffer.size());
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                fds[i].fd = -1;
+                open_streams--;
+            } else if (i == 0) {
+                output.append(buffer.data(), static_cast<size_t>(n));
+            } else {
+                errors.append(buffer.data(), static_cast<size_t>(n));
+            }
+        }
+    }
+    return true;
+}
+
+bool RenderManager::checkManim(std::string& version) {
+    // Bounded: this runs on the caller's thread, usually Tk's, and python
+    // can hang importing manim
+    std::string waited = std::to_string(check_timeout_ms / 1000) + " s";
+    std::string output;
+    OutputRing errors(4096);
+
+    if (!worker_pool.enabled()) {
+        ChildProcess child;
+        try {
+            child = spawnProcessGroup({"python", "-c", "import manim; print(manim.__version__)"});
+        } catch (const std::exception& e) {
+            version = e.what();
+            return false;
+        }
+        bool finished = readCheckOutput(child, output, errors, nullptr);
+        if (!finished) signalProcessGroup(child, SIGKILL);
+        int status = waitProcess(child);
+        if (!finished) {
+            version = "python did not import manim within " + waited;
+            return false;
+        }
+        bool succeeded = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        if (!succeeded) output = errors.str();
+        output.erase(output.find_last_not_of(" \t\r\n") + 1);
+        version = output.substr(output.find_last_of('\n') + 1);
+        return succeeded;
+    }
+
+    // Ping a warm worker; starting it here also means the first real
+    // render finds manim already imported
+    std::unique_ptr<ManimWorker> worker;
+    try {
+        worker = worker_pool.acquire();
+    } catch (const std::exception& e) {
+        version = e.what();
+        return false;
+    }
+    std::string marker = std::string("\n") + MANIM_WORKER_DONE + " ";
+    auto answered = [&marker](const std::string& text) {
+        size_t pos = text.find(marker);
+        return pos != std::string::npos && text.find('\n', pos + marker.size()) != std::string::npos;
+    };
+    if (!writeAll(worker->process.in_fd, "{\"cmd\": \"ping\"}\n")) {
+        worker_pool.discard(std::move(worker));
+        return false;
+    }
+    if (!readCheckOutput(worker->process, output, errors, answered)) {
+        version = "the Manim worker did not answer within " + waited;
+        worker_pool.discard(std::move(worker));
+        return false;
+    }
+    if (!answered(output)) {
+        worker_pool.discard(std::move(worker));
+        return false;
+    }
+    version = jsonField(output.substr(output.find(marker) + marker.size()), "version");
+    worker_pool.release(std::move(worker));
+    return true;
+}
+
+void RenderManager::removeJobOutput(const std::string& script_path) {
+    if (script_path.empty()) return;
+
+    // Manim names its output folders after the script's stem
+    std::filesystem::path script(script_path);
+    std::string stem = script.stem().string();
+    std::error_code ec;
+    std::filesystem::remove(script, ec);
+    std::filesystem::remove(ManimScript::dataPath(script_path), ec);
+    std::filesystem::remove_all(std::filesystem::path("media") / "videos" / stem, ec);
+    std::filesystem::remove_all(std::filesystem::path("media") / "images" / stem, ec);
+}
+
+std::string RenderManager::scriptPath(const RenderOptions& options, int job_id) {
+    return options.filename + "_" + std::to_string(job_id) + ".py";
+}
+
+void RenderManager::takeVideoPaths(std::string& pending, std::vector<std::string>& paths) {
+    static const std::string ready = "File ready at";
+    while (true) {
+        size_t pos = pending.find(ready);
+        if (pos == std::string::npos) {
+            // Keep just enough to catch the phrase split across reads
+            if (pending.size() >= ready.size()) pending.erase(0, pending.size() - ready.size() + 1);
+            return;
+        }
+        size_t open = pending.find('\'', pos);
+        size_t close = open == std::string::npos ? open : pending.find('\'', open + 1);
+        if (close == std::string::npos) {
+            // The path is still arriving; a message never closed shouldn't
+            // pile up forever either
+            pending.erase(0, pos);
+            if (pending.size() > 64 * 1024) pending.clear();
+            return;
+        }
+        for (auto& path : extractVideoPaths(pending.substr(pos, close + 1 - pos))) {
+            paths.push_back(std::move(path));
+        }
+        pending.erase(0, close + 1);
+    }
+}
+
+std::vector<std::string> RenderManager::extractVideoPaths(const std::string& output) {
+    // Manim prints "File ready at '...'" once per rendered scene, in order.
+    // Its rich logger wraps long paths over several indented lines, so
+    // collect everything up to the closing quote and drop the padding.
+    std::vector<std::string> paths;
+    size_t pos = 0;
+    while ((pos = output.find("File ready at", pos)) != std::string::npos) {
+        pos += 13;
+        size_t open = output.find('\'', pos);
+        if (open == std::string::npos) break;
+        size_t close = output.find('\'', open + 1);
+        if (close == std::string::npos) break;
+
+        std::string path;
+        bool at_line_start = false;
+        for (size_t i = open + 1; i < close; i++) {
+            char c = output[i];
+            if (c == '\n' || c == '\r') {
+                at_line_start = true;
+                continue;
+            }
+            if (at_line_start && (c == ' ' || c == '\t')) continue;
+            at_line_start = false;
+            path += c;
+        }
+        paths.push_back(path);
+        pos = close + 1;
+    }
+    return paths;
+}
@@ -0,0 +1,290 @@
+// src/RenderManager.hpp
+#ifndef RENDERMANAGER_HPP
+#define RENDERMANAGER_HPP
+
+#include "AssetGraph.hpp"
+#include "ManimWorkerPool.hpp"
+#include "RenderCache.hpp"
+#include "RenderEstimator.hpp"
+#include "RenderJob.hpp"
+#include "RenderTelemetry.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Runs Manim renders on worker threads so the Tk main loop keeps
+// servicing events while a (possibly minutes long) render is in flight.
+// Submitted jobs wait in a priority queue and at most `max_concurrent`
+// of them run at once. Equal priorities start in submission order, except
+// previews, where the one estimated to finish soonest goes first. Jobs are
+// planned and estimated on a thread of their own after they are queued,
+// as that takes seconds for long scenes.
+class RenderManager {
+public:
+    // Watchdog limits for a running job; 0 turns a limit off
+    struct Limits {
+        double wall_seconds = 0.0;  // since the job started
+        long memory_kb = 0;         // resident memory of all its processes together
+    };
+
+    // Invoked on the worker thread with a snapshot of the finished job
+    using FinishedCallback = std::function<void(const RenderJob&)>;
+    // Invoked on the worker thread, at most once per progress interval
+    using ProgressCallback = std::function<void(int job_id, const RenderProgress&)>;
+    // Invoked on a worker thread as a segmented render's clips become
+    // playable: in scene order, once every clip before them exists
+    using SegmentCallback = std::function<void(int job_id, int index, int count, const std::string& clip)>;
+    // Invoked on the planner or a worker thread once a submitted job's
+    // time has been estimated; -1 if there is nothing to estimate it from
+    using PlannedCallback = std::function<void(int job_id, double estimated_seconds)>;
+
+private:
+    mutable std::mutex mutex;
+    std::map<int, std::shared_ptr<RenderJob>> jobs;
+    std::map<int, std::thread> workers;
+    std::vector<int> finished_workers;  // threads that can be joined
+    int next_job_id = 1;
+
+    // (-priority, rank, id) of waiting jobs; see queueKey
+    std::set<std::tuple<int, long, int>> queue;
+    int max_concurrent = 1;
+    int running_jobs = 0;
+    int extra_processes = 0;  // Manim processes beyond one per running job
+    bool shutting_down = false;
+
+    // Samples running jobs' process groups from /proc and stops a job
+    // that goes over `limits`
+    std::thread monitor_thread;
+    std::condition_variable monitor_wake;
+    int monitor_interval_ms = 500;
+    Limits limits;
+
+    // Plans queued jobs in submission order, then puts each in its place
+    // in the queue by its estimate; a job that starts first plans itself
+    std::thread planner_thread;
+    std::condition_variable planner_wake;
+    std::deque<int> unplanned;
+
+    ManimWorkerPool worker_pool;
+    std::string scene_runner_dir = "build/python";  // holds scene_runner.py; set before submitting
+    RenderCache render_cache;
+    RenderCache segment_cache;
+    std::atomic<bool> cache_enabled{true};
+    std::atomic<bool> segment_cache_enabled{true};
+    std::atomic<int> render_parallelism{1};
+    RenderTelemetry render_telemetry;
+    RenderEstimator render_estimator{render_telemetry};
+    AssetManifest asset_manifest;
+
+    FinishedCallback finished_callback;
+    ProgressCallback progress_callback;
+    SegmentCallback segment_callback;
+    PlannedCallback planned_callback;
+    int progress_interval_ms = 100;
+    int cancel_grace_ms = 3000;  // SIGTERM -> SIGKILL escalation delay
+    int check_timeout_ms = 15000;  // how long checkManim waits for manim to import
+
+    enum class RunResult { Succeeded, Failed, Cancelled };
+
+    // One Manim invocation: render `scenes` from `script_path`
+    struct ManimRun {
+        std::string script_path;
+        std::vector<std::string> scenes;
+        int animation_count = 0;
+        std::vector<std::string> tex;     // LaTeX to batch compile before the scenes
+
+        // Receives progress instead of the job when set
+        std::function<void(const RenderProgress&)> on_progress;
+        // Told about each scene's video as soon as it is written
+        std::function<void(size_t scene, const std::string& video)> on_video;
+
+        std::vector<std::string> videos;  // one per scene, in order
+        OutputRing output;                // stdout and stderr, bounded
+        int status = 0;                   // waitpid status of a one-shot run
+        std::string error;
+        std::string reply;                // the warm worker's JSON reply
+    };
+
+    // Folds the progress of concurrent Manim runs into one bar for the job
+    struct ParallelProgress {
+        std::mutex mutex;
+        std::vector<RenderProgress> runs;
+        int animation_count = 0;
+        std::chrono::milliseconds interval{0};
+        std::chrono::steady_clock::time_point last_report;
+
+        // Record `progress` for run `run`; true if `combined` should be reported
+        bool update(size_t run, const RenderProgress& progress, RenderProgress& combined);
+    };
+
+    // Gets each chunk of a child's output; return true to stop reading
+    // `stream` is STDOUT_FILENO or STDERR_FILENO
+    using OutputHandler = std::function<bool(int stream, const char* data, size_t length)>;
+
+    void runJob(std::shared_ptr<RenderJob> job);
+    RunResult precompileTex(const std::shared_ptr<RenderJob>& job, const std::vector<std::string>& snippets);
+    RunResult renderWhole(const std::shared_ptr<RenderJob>& job, const AssetGraph& graph,
+                          const std::string& scene_data, std::string& video_path, std::string& error);
+    RunResult renderSegmented(const std::shared_ptr<RenderJob>& job, const AssetGraph& graph,
+                              std::string& video_path, std::string& error);
+    RunResult concatClips(const std::shared_ptr<RenderJob>& job, const std::vector<std::string>& clips,
+                          const std::string& output, std::string& error);
+    RunResult runManim(const std::shared_ptr<RenderJob>& job, ManimRun& run);
+    RunResult runTool(const std::shared_ptr<RenderJob>& job, const std::vector<std::string>& argv,
+                      OutputRing& output);
+    RunResult pumpProcess(const std::shared_ptr<RenderJob>& job, const ChildProcess& child,
+                          const OutputHandler& on_output);
+    bool cancelRequested(const std::shared_ptr<RenderJob>& job);
+    // Read a check's stdout into `output` and its stderr into `errors` until
+    // `done` says it has what it needs or both pipes close; false if
+    // check_timeout_ms passed first
+    bool readCheckOutput(const ChildProcess& child, std::string& output, OutputRing& errors,
+                         const std::function<bool(const std::string&)>& done);
+    // Fill in the video's length and where each animation starts, from
+    // the segment clips' lengths when the scene was rendered in segments
+    void timeAnimations(const std::shared_ptr<RenderJob>& job, const std::string& video_path,
+                        const std::vector<std::string>& clips);
+    void recordUsage(const std::shared_ptr<RenderJob>& job, const std::string& program,
+                     int status, const ProcessUsage& usage);
+    // Add the wall time since `start` to the job's `stage`
+    void addStageTime(const std::shared_ptr<RenderJob>& job, const char* stage,
+                      std::chrono::steady_clock::time_point start);
+    void finishJob(const std::shared_ptr<RenderJob>& job, RenderState state,
+                   const std::string& message);
+    // End a job that stopped on `cancel_requested`: Cancelled, or Failed
+    // with the reason when the watchdog stopped it
+    void finishStopped(const std::shared_ptr<RenderJob>& job);
+    void monitorLoop();
+    void planLoop();
+    void reapFinishedWorkers();
+    // A job for `equations` trimmed to its range, not planned yet; needs no lock
+    std::shared_ptr<RenderJob> prepare(const RenderOptions& options, std::vector<MathEquation> equations);
+    // Fill in what is left to render and the asset decisions, and the
+    // estimate if it wasn't known yet. Unless `started`, from the job's own
+    // worker, nothing changes once the job has started, as it plans again.
+    void plan(const std::shared_ptr<RenderJob>& job, const AssetGraph& graph, bool started);
+    void enqueue(const std::shared_ptr<RenderJob>& job);
+    static std::tuple<int, long, int> queueKey(const RenderJob& job);
+    // The assets rendering `equations` is built from, and which of them
+    // have to be built now
+    AssetGraph planAssets(const RenderOptions& options, const std::vector<MathEquation>& equations);
+    void dispatchQueued();
+    void reportProgress(const std::shared_ptr<RenderJob>& job, const RenderProgress& progress);
+
+public:
+    RenderManager();
+    ~RenderManager();
+
+    void setFinishedCallback(FinishedCallback callback);
+    void setProgressCallback(ProgressCallback callback);
+    void setSegmentCallback(SegmentCallback callback);
+    void setPlannedCallback(PlannedCallback callback);
+
+    // Minimum time between progress callbacks for one job
+    void setProgressInterval(int milliseconds);
+
+    // Render through warm python/manim_worker.py processes instead of a
+    // fresh `python -m manim` per job; empty path turns this off
+    void setWorkerScript(const std::string& path);
+
+    // Directory of python/scene_runner.py, which the generated stub
+    // scripts import
+    void setSceneRunnerDirectory(const std::string& path) { scene_runner_dir = path; }
+
+    RenderCache& cache() { return render_cache; }
+    void setCacheEnabled(bool enabled) { cache_enabled = enabled; }
+    bool cacheEnabled() const { return cache_enabled; }
+
+    // Per-animation clips, so an edit only re-renders the segments whose
+    // picture it changes and the rest are joined from cache
+    RenderCache& segmentCache() { return segment_cache; }
+    void setSegmentCacheEnabled(bool enabled) { segment_cache_enabled = enabled; }
+    bool segmentCacheEnabled() const { return segment_cache_enabled; }
+
+    // Manim processes a render may split its segments across; defaults to
+    // the number of cores, 1 renders segments in a single process. Running
+    // renders split it between them, so it is also the most that run at
+    // once for all of them together (beyond one each).
+    void setRenderParallelism(int processes);
+    int renderParallelism() const { return render_parallelism; }
+
+    // Per-stage timings of finished renders, kept across sessions
+    RenderTelemetry& telemetry() { return render_telemetry; }
+
+    // How long rendering `equations` with `options` would take, from the
+    // renders in telemetry; `work` gets what it was estimated from
+    RenderEstimator::Estimate estimate(const RenderOptions& options, std::vector<MathEquation> equations,
+                                       RenderWork& work);
+
+    // What rendering `equations` with `options` would rebuild, and why,
+    // without rendering. Both plan on the caller's thread.
+    std::vector<AssetDecision> explain(const RenderOptions& options, std::vector<MathEquation> equations);
+
+    // Defaults: no wall-time limit, memory limit at 3/4 of physical RAM
+    void setLimits(const Limits& limits);
+    Limits getLimits() const;
+
+    // Check that manim imports; fills in its version, or why it could not
+    // be run. Blocks the caller for up to 15 s.
+    bool checkManim(std::string& version);
+
+    // Queue a render of the given scene snapshot; returns the job id at
+    // once, before the job is planned
+    int submit(const RenderOptions& options, std::vector<MathEquation> equations);
+
+    // Progressive render: a -ql draft at the given priority, then a -qh
+    // job at background priority that starts once the draft has finished
+    // and reuses its typeset LaTeX. Returns {draft id, final id}.
+    std::pair<int, int> submitProgressive(const RenderOptions& options, std::vector<MathEquation> equations);
+
+    // Renders allowed to run at the same time; defaults to the core count
+    void setMaxConcurrent(int jobs);
+    int maxConcurrent() const;
+
+    // Change a job's priority; a queued job moves to its new place in line.
+    // False if the job is unknown or already finished.
+    bool reprioritize(int id, int priority);
+
+    // Running jobs, then queued ones in the order they will start
+    std::vector<RenderJob> queueSnapshot() const;
+
+    // Copy of a job's current state; false if the id is unknown
+    bool getJob(int id, RenderJob& out) const;
+
+    int activeJobCount() const;
+
+    // Stop a running job: SIGTERM its whole process group, SIGKILL after
+    // the grace period, then delete its partial media. A queued job is
+    // just dropped. False if the job is unknown or already finished.
+    bool cancel(int id);
+
+    // Cancel every in-flight render and wait for the workers to exit
+    void shutdown();
+
+    // Scene file generated for a job; its stem also names Manim's media dirs
+    static std::string scriptPath(const RenderOptions& options, int job_id);
+
+    // Remove the script, its scene data and the media Manim wrote for it
+    static void removeJobOutput(const std::string& script_path);
+
+    // Pull the output paths out of Manim's "File ready at '...'" messages
+    static std::vector<std::string> extractVideoPaths(const std::string& output);
+
+    // Move the paths of complete "File ready at" messages in streamed
+    // output from `pending` into `paths`, keeping any unfinished tail
+    static void takeVideoPaths(std::string& pending, std::vector<std::string>& paths);
+};
+
+#endif
@@ -0,0 +1,325 @@
+// src/RenderTelemetry.cpp
+#include "RenderTelemetry.hpp"
+
+#include <sqlite3.h>
+
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <map>
+
+namespace {
+
+// Bump with a migration when the tables change
+const int SCHEMA_VERSION = 2;
+
+const char* SCHEMA =
+    "CREATE TABLE IF NOT EXISTS renders ("
+    "  id INTEGER PRIMARY KEY,"
+    "  job INTEGER NOT NULL,"
+    "  finished REAL NOT NULL,"
+    "  state TEXT NOT NULL,"
+    "  quality TEXT NOT NULL,"
+    "  still INTEGER NOT NULL,"
+    "  equations INTEGER NOT NULL,"
+    "  scene_bytes INTEGER NOT NULL,"
+    "  cache_hit INTEGER NOT NULL,"
+    "  segments_total INTEGER NOT NULL,"
+    "  segments_rendered INTEGER NOT NULL,"
+    "  queue_seconds REAL NOT NULL,"
+    "  total_seconds REAL NOT NULL,"
+    "  cpu_seconds REAL NOT NULL,"
+    "  max_rss_kb INTEGER NOT NULL,"
+    "  exit_status INTEGER NOT NULL,"
+    "  animations INTEGER NOT NULL DEFAULT -1,"
+    "  writes INTEGER NOT NULL DEFAULT 0,"
+    "  transforms INTEGER NOT NULL DEFAULT 0,"
+    "  tex_tokens INTEGER NOT NULL DEFAULT 0,"
+    "  estimated_seconds REAL NOT NULL DEFAULT -1);"
+    "CREATE TABLE IF NOT EXISTS stages ("
+    "  render_id INTEGER NOT NULL REFERENCES renders(id) ON DELETE CASCADE,"
+    "  stage TEXT NOT NULL,"
+    "  seconds REAL NOT NULL);"
+    "CREATE INDEX IF NOT EXISTS stages_render ON stages(render_id);";
+
+// Version 2 adds what each render had to do and what it was estimated to
+// take; renders recorded before that have animations = -1
+const char* MIGRATE_1_TO_2 =
+    "ALTER TABLE renders ADD COLUMN animations INTEGER NOT NULL DEFAULT -1;"
+    "ALTER TABLE renders ADD COLUMN writes INTEGER NOT NULL DEFAULT 0;"
+    "ALTER TABLE renders ADD COLUMN transforms INTEGER NOT NULL DEFAULT 0;"
+    "ALTER TABLE renders ADD COLUMN tex_tokens INTEGER NOT NULL DEFAULT 0;"
+    "ALTER TABLE renders ADD COLUMN estimated_seconds REAL NOT NULL DEFAULT -1;";
+
+// Finalizes the statement when it goes out of scope
+class Statement {
+public:
+    sqlite3_stmt* stmt = nullptr;
+
+    Statement(sqlite3* db, const char* sql) {
+        sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+    }
+    ~Statement() { sqlite3_finalize(stmt); }
+
+    Statement(const Statement&) = delete;
+    Statement& operator=(const Statement&) = delete;
+};
+
+double secondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    if (from == std::chrono::steady_clock::time_point() || to == std::chrono::steady_clock::time_point()) return 0.0;
+    return std::chrono::duration<double>(to - from).count();
+}
+
+std::string columnText(sqlite3_stmt* stmt, int column) {
+    const unsigned char* text = sqlite3_column_text(stmt, column);
+    return text ? reinterpret_cast<const char*>(text) : "";
+}
+
+}
+
+RenderTelemetry::~RenderTelemetry() {
+    if (db) sqlite3_close(db);
+}
+
+void RenderTelemetry::setPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (db) {
+        sqlite3_close(db);
+        db = nullptr;
+    }
+    this->path = path;
+    disabled = false;
+    records_written++;
+}
+
+long RenderTelemetry::generation() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return records_written;
+}
+
+bool RenderTelemetry::exec(const char* sql, std::string& error) {
+    char* message = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &message) != SQLITE_OK) {
+        error = message ? message : sqlite3_errmsg(db);
+        sqlite3_free(message);
+        return false;
+    }
+    return true;
+}
+
+bool RenderTelemetry::open(std::string& error) {
+    if (db) return true;
+    if (disabled) {
+        error = "Render telemetry is off: " + path + " could not be used";
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+
+    if (sqlite3_open(path.c_str(), &db) != SQLITE_OK) {
+        error = "Could not open " + path + ": " + sqlite3_errmsg(db);
+        sqlite3_close(db);
+        db = nullptr;
+        disabled = true;
+        return false;
+    }
+    // Renders finish on worker threads while the GUI may be querying
+    sqlite3_busy_timeout(db, 2000);
+
+    // WAL with normal sync keeps an insert from costing an fsync per render.
+    // The journal mode can't change inside a transaction, so it comes first.
+    bool ok = exec("PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL; PRAGMA foreign_keys=ON;", error) &&
+              exec("BEGIN IMMEDIATE", error);
+
+    // The version is read inside the transaction so two instances starting
+    // together don't both migrate, and the tables and the version change
+    // together or not at all: a migration cut short is simply run again
+    int version = 0;
+    if (ok) {
+        Statement query(db, "PRAGMA user_version");
+        if (query.stmt && sqlite3_step(query.stmt) == SQLITE_ROW) version = sqlite3_column_int(query.stmt, 0);
+    }
+    if (ok && version > SCHEMA_VERSION) {
+        // Written by a newer build; leave its tables alone
+        error = "schema version " + std::to_string(version) + " is newer than this build's " +
+                std::to_string(SCHEMA_VERSION);
+        ok = false;
+    }
+    ok = ok && exec(SCHEMA, error) &&
+         (version != 1 || exec(MIGRATE_1_TO_2, error)) &&
+         exec(("PRAGMA user_version=" + std::to_string(SCHEMA_VERSION)).c_str(), error) &&
+         exec("COMMIT", error);
+    if (!ok) {
+        error = "Could not set up " + path + ": " + error;
+        if (!sqlite3_get_autocommit(db)) sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        sqlite3_close(db);
+        db = nullptr;
+        disabled = true;
+        return false;
+    }
+    return true;
+}
+
+void RenderTelemetry::record(const RenderJob& job) {
+    if (job.started_at == std::chrono::steady_clock::time_point()) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string error;
+    if (!open(error)) {
+        if (!disabled) return;
+        // Say it once, then stay quiet
+        static bool reported = false;
+        if (!reported) std::cerr << "[C++] " << error << std::endl;
+        reported = true;
+        return;
+    }
+
+    Statement insert(db,
+        "INSERT INTO renders (job, finished, state, quality, still, equations, scene_bytes, cache_hit,"
+        " segments_total, segments_rendered, queue_seconds, total_seconds, cpu_seconds, max_rss_kb, exit_status,"
+        " animations, writes, transforms, tex_tokens, estimated_seconds)"
+        " VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    Statement stage(db, "INSERT INTO stages (render_id, stage, seconds) VALUES (?, ?, ?)");
+    if (!insert.stmt || !stage.stmt) {
+        std::cerr << "[C++] Render telemetry: " << sqlite3_errmsg(db) << std::endl;
+        return;
+    }
+
+    double now = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    sqlite3_bind_int(insert.stmt, 1, job.id);
+    sqlite3_bind_double(insert.stmt, 2, now);
+    sqlite3_bind_text(insert.stmt, 3, renderStateName(job.state), -1, SQLITE_STATIC);
+    sqlite3_bind_text(insert.stmt, 4, job.options.quality.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(insert.stmt, 5, job.options.still_frame);
+    sqlite3_bind_int(insert.stmt, 6, static_cast<int>(job.equations.size()));
+    sqlite3_bind_int64(insert.stmt, 7, static_cast<sqlite3_int64>(job.scene_bytes));
+    sqlite3_bind_int(insert.stmt, 8, job.cache_hit);
+    sqlite3_bind_int(insert.stmt, 9, job.segments_total);
+    sqlite3_bind_int(insert.stmt, 10, job.segments_rendered);
+    sqlite3_bind_double(insert.stmt, 11, secondsBetween(job.submitted_at, job.started_at));
+    sqlite3_bind_double(insert.stmt, 12, secondsBetween(job.started_at, job.finished_at));
+    sqlite3_bind_double(insert.stmt, 13, job.usage.user_seconds + job.usage.system_seconds);
+    sqlite3_bind_int64(insert.stmt, 14, job.usage.max_rss_kb);
+    sqlite3_bind_int(insert.stmt, 15, job.exit_status);
+    sqlite3_bind_int(insert.stmt, 16, job.work.animations);
+    sqlite3_bind_int(insert.stmt, 17, job.work.writes);
+    sqlite3_bind_int(insert.stmt, 18, job.work.transforms);
+    sqlite3_bind_int(insert.stmt, 19, job.work.tex_tokens);
+    sqlite3_bind_double(insert.stmt, 20, job.estimated_seconds);
+
+    exec("BEGIN", error);
+    bool ok = sqlite3_step(insert.stmt) == SQLITE_DONE;
+    sqlite3_int64 render_id = sqlite3_last_insert_rowid(db);
+    for (size_t i = 0; ok && i < job.stage_seconds.size(); i++) {
+        sqlite3_reset(stage.stmt);
+        sqlite3_bind_int64(stage.stmt, 1, render_id);
+        sqlite3_bind_text(stage.stmt, 2, job.stage_seconds[i].first.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_double(stage.stmt, 3, job.stage_seconds[i].second);
+        ok = sqlite3_step(stage.stmt) == SQLITE_DONE;
+    }
+    if (!ok) {
+        std::cerr << "[C++] Render telemetry for job #" << job.id << " not saved: " << sqlite3_errmsg(db) << std::endl;
+        exec("ROLLBACK", error);
+        return;
+    }
+    exec("COMMIT", error);
+    records_written++;
+}
+
+bool RenderTelemetry::recent(int limit, std::vector<Record>& records, std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!open(error)) return false;
+
+    Statement select(db,
+        "SELECT id, job, finished, state, quality, still, equations, scene_bytes, cache_hit, segments_total,"
+        " segments_rendered, queue_seconds, total_seconds, cpu_seconds, max_rss_kb, exit_status,"
+        " animations, writes, transforms, tex_tokens, estimated_seconds"
+        " FROM renders ORDER BY id DESC LIMIT ?");
+    Statement stages(db,
+        "SELECT render_id, stage, seconds FROM stages WHERE render_id >= ? ORDER BY rowid");
+    if (!select.stmt || !stages.stmt) {
+        error = sqlite3_errmsg(db);
+        return false;
+    }
+
+    sqlite3_bind_int(select.stmt, 1, limit);
+    std::map<int, size_t> by_id;
+    while (sqlite3_step(select.stmt) == SQLITE_ROW) {
+        Record r;
+        r.id = sqlite3_column_int(select.stmt, 0);
+        r.job = sqlite3_column_int(select.stmt, 1);
+        r.finished = sqlite3_column_double(select.stmt, 2);
+        r.state = columnText(select.stmt, 3);
+        r.quality = columnText(select.stmt, 4);
+        r.still = sqlite3_column_int(select.stmt, 5) != 0;
+        r.equations = sqlite3_column_int(select.stmt, 6);
+        r.scene_bytes = static_cast<size_t>(sqlite3_column_int64(select.stmt, 7));
+        r.cache_hit = sqlite3_column_int(select.stmt, 8) != 0;
+        r.segments_total = sqlite3_column_int(select.stmt, 9);
+        r.segments_rendered = sqlite3_column_int(select.stmt, 10);
+        r.queue_seconds = sqlite3_column_double(select.stmt, 11);
+        r.total_seconds = sqlite3_column_double(select.stmt, 12);
+        r.cpu_seconds = sqlite3_column_double(select.stmt, 13);
+        r.max_rss_kb = static_cast<long>(sqlite3_column_int64(select.stmt, 14));
+        r.exit_status = sqlite3_column_int(select.stmt, 15);
+        r.work.animations = sqlite3_column_int(select.stmt, 16);
+        r.work.writes = sqlite3_column_int(select.stmt, 17);
+        r.work.transforms = sqlite3_column_int(select.stmt, 18);
+        r.work.tex_tokens = sqlite3_column_int(select.stmt, 19);
+        r.estimated_seconds = sqlite3_column_double(select.stmt, 20);
+        by_id[r.id] = records.size();
+        records.push_back(std::move(r));
+    }
+    if (records.empty()) return true;
+
+    // Ids are descending, so the last record is the oldest
+    sqlite3_bind_int(stages.stmt, 1, records.back().id);
+    while (sqlite3_step(stages.stmt) == SQLITE_ROW) {
+        auto it = by_id.find(sqlite3_column_int(stages.stmt, 0));
+        if (it == by_id.end()) continue;
+        records[it->second].stages.emplace_back(columnText(stages.stmt, 1),
+                                                sqlite3_column_double(stages.stmt, 2));
+    }
+    return true;
+}
+
+bool RenderTelemetry::summarize(int limit, const std::string& by, std::vector<Summary>& summaries,
+                                std::string& error) {
+    std::string sql;
+    if (by == "stage") {
+        sql = "SELECT stage, COUNT(*), SUM(seconds), AVG(seconds), MAX(seconds) FROM stages"
+              " WHERE render_id IN (SELECT id FROM renders ORDER BY id DESC LIMIT ?1)"
+              " GROUP BY stage ORDER BY SUM(seconds) DESC";
+    } else if (by == "quality" || by == "state") {
+        // `by` is one of two known column names, never user text
+        sql = "SELECT " + by + ", COUNT(*), SUM(total_seconds), AVG(total_seconds), MAX(total_seconds)"
+              " FROM (SELECT * FROM renders ORDER BY id DESC LIMIT ?1)"
+              " GROUP BY " + by + " ORDER BY SUM(total_seconds) DESC";
+    } else {
+        error = "bad grouping \"" + by + "\": must be stage, quality or state";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!open(error)) return false;
+
+    Statement select(db, sql.c_str());
+    if (!select.stmt) {
+        error = sqlite3_errmsg(db);
+        return false;
+    }
+    sqlite3_bind_int(select.stmt, 1, limit);
+    while (sqlite3_step(select.stmt) == SQLITE_ROW) {
+        Summary s;
+        s.key = columnText(select.stmt, 0);
+        s.count = sqlite3_column_int(select.stmt, 1);
+        s.total = sqlite3_column_double(select.stmt, 2);
+        s.mean = sqlite3_column_double(select.stmt, 3);
+        s.max = sqlite3_column_double(select.stmt, 4);
+        summaries.push_back(std::move(s));
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+// src/RenderTelemetry.hpp
+#ifndef RENDERTELEMETRY_HPP
+#define RENDERTELEMETRY_HPP
+
+#include "RenderJob.hpp"
+
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct sqlite3;
+
+// Per-render timing records in a local SQLite database: one row per
+// finished job (state, scene size, cache use, queue and total time, CPU,
+// exit status) and one row per stage it went through (script, cache, tex,
+// animation, concat). Recording never fails a render; if the database
+// can't be opened or written, telemetry switches itself off and says so.
+class RenderTelemetry {
+public:
+    struct Record {
+        int id = 0;
+        int job = 0;
+        double finished = 0.0;         // unix time
+        std::string state;
+        std::string quality;
+        bool still = false;
+        int equations = 0;
+        size_t scene_bytes = 0;
+        bool cache_hit = false;
+        int segments_total = 0;
+        int segments_rendered = 0;
+        double queue_seconds = 0.0;
+        double total_seconds = 0.0;
+        double cpu_seconds = 0.0;
+        long max_rss_kb = 0;
+        int exit_status = 0;
+        RenderWork work;               // animations is -1 for renders recorded before it was
+        double estimated_seconds = -1.0;
+        std::vector<std::pair<std::string, double>> stages;
+    };
+
+    // Renders grouped by stage, quality or state
+    struct Summary {
+        std::string key;
+        int count = 0;
+        double total = 0.0;
+        double mean = 0.0;
+        double max = 0.0;
+    };
+
+private:
+    std::mutex mutex;
+    std::string path = "render_cache/telemetry.db";
+    sqlite3* db = nullptr;
+    bool disabled = false;
+    long records_written = 0;
+
+    // Caller holds `mutex`
+    bool open(std::string& error);
+    bool exec(const char* sql, std::string& error);
+
+public:
+    ~RenderTelemetry();
+
+    void setPath(const std::string& path);
+
+    // Store a finished job; jobs that never started are skipped
+    void record(const RenderJob& job);
+
+    // Changes whenever a render is recorded or the database is switched,
+    // so anything derived from the records knows to recompute
+    long generation();
+
+    // The newest `limit` renders, newest first
+    bool recent(int limit, std::vector<Record>& records, std::string& error);
+
+    // Stage or total times of the newest `limit` renders, grouped by
+    // "stage", "quality" or "state", largest total first
+    bool summarize(int limit, const std::string& by, std::vector<Summary>& summaries, std::string& error);
+};
+
+#endif
@@ -6,6 +6,7 @@
 #define SCENEMANAGER_HPP
 
 #include "Equation.hpp"
+#include <functional>
 #include <vector>
 #include <memory>
 
@@ -13,11 +14,22 @@ class SceneManager {
 private:
     std::vector<std::unique_ptr<MathEquation>> equations;
     int next_id = 0;
+    std::function<void()> change_callback;
+    
+    void changed() {
+        if (change_callback) change_callback();
+    }
     
 public:
+    // Called after every edit, e.g. to schedule a preview render
+    void setChangeCallback(std::function<void()> callback) {
+        change_callback = std::move(callback);
+    }
+    
     // Add equation and return its ID
     int addEquation(const std::string& latex, double x, double y) {
         equations.emplace_back(std::make_unique<MathEquation>(latex, x, y, next_id));
+        changed();
         return next_id++;
     }
     
@@ -34,12 +46,23 @@ public:
     void clearAll() {
         equations.clear();
         next_id = 0;
+        changed();
     }
     
     // Get equations for Manim generation
     const std::vector<std::unique_ptr<MathEquation>>& getEquations() const {
         return equations;
     }
+    
+    // Copy of the current equations, for handing to a render worker
+    std::vector<MathEquation> snapshot() const {
+        std::vector<MathEquation> copy;
+        copy.reserve(equations.size());
+        for (const auto& eq : equations) {
+            copy.push_back(*eq);
+        }
+        return copy;
+    }
 };
 
 #endif
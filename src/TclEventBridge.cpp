@@ -0,0 +1,74 @@
+// src/TclEventBridge.cpp
+#include "TclEventBridge.hpp"
+#include <iostream>
+
+namespace {
+
+// Tcl frees the event with Tcl_Free once serviceEvent returns 1, so it
+// only carries a pointer back to the bridge; the payload lives in `pending`.
+struct BridgeEvent {
+    Tcl_Event header;
+    TclEventBridge* bridge;
+};
+
+}
+
+void TclEventBridge::attach(Tcl_Interp* interp) {
+    this->interp = interp;
+    interp_thread = Tcl_GetCurrentThread();
+}
+
+void TclEventBridge::detach() {
+    std::lock_guard<std::mutex> lock(mutex);
+    interp = nullptr;
+    pending.clear();
+}
+
+void TclEventBridge::post(std::vector<std::string> words) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!interp) return;
+
+    pending.push_back(std::move(words));
+
+    // One queued event drains everything pending, so don't flood the
+    // notifier when a worker posts faster than the GUI services events.
+    if (event_queued) return;
+    event_queued = true;
+
+    BridgeEvent* ev = static_cast<BridgeEvent*>(Tcl_Alloc(sizeof(BridgeEvent)));
+    ev->header.proc = serviceEvent;
+    ev->header.nextPtr = nullptr;
+    ev->bridge = this;
+    Tcl_ThreadQueueEvent(interp_thread, &ev->header, TCL_QUEUE_TAIL);
+    Tcl_ThreadAlert(interp_thread);
+}
+
+int TclEventBridge::serviceEvent(Tcl_Event* ev, int) {
+    reinterpret_cast<BridgeEvent*>(ev)->bridge->drain();
+    return 1;
+}
+
+void TclEventBridge::drain() {
+    std::deque<std::vector<std::string>> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch.swap(pending);
+        event_queued = false;
+    }
+    if (!interp) return;
+
+    for (const auto& words : batch) {
+        Tcl_Obj* cmd = Tcl_NewListObj(0, nullptr);
+        for (const auto& word : words) {
+            Tcl_ListObjAppendElement(nullptr, cmd, Tcl_NewStringObj(word.c_str(), -1));
+        }
+        Tcl_IncrRefCount(cmd);
+        int code = Tcl_EvalObjEx(interp, cmd, TCL_EVAL_GLOBAL);
+        if (code != TCL_OK) {
+            std::cerr << "[C++] Background command failed: "
+                      << Tcl_GetStringResult(interp) << std::endl;
+            Tcl_BackgroundException(interp, code);
+        }
+        Tcl_DecrRefCount(cmd);
+    }
+}
@@ -0,0 +1,38 @@
+// src/TclEventBridge.hpp
+#ifndef TCLEVENTBRIDGE_HPP
+#define TCLEVENTBRIDGE_HPP
+
+#include <tcl.h>
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Hands Tcl commands from worker threads to the interpreter thread.
+// Tcl objects and interpreters must only be touched by the thread that
+// created them, so workers queue plain strings here and the Tcl event
+// loop turns them into command invocations.
+class TclEventBridge {
+private:
+    Tcl_Interp* interp = nullptr;
+    Tcl_ThreadId interp_thread = nullptr;
+
+    std::mutex mutex;
+    std::deque<std::vector<std::string>> pending;
+    bool event_queued = false;
+
+    static int serviceEvent(Tcl_Event* ev, int flags);
+    void drain();
+
+public:
+    // Must be called from the thread that owns the interpreter
+    void attach(Tcl_Interp* interp);
+    void detach();
+
+    // Queue "word0 word1 ..." to be evaluated at global level.
+    // Safe to call from any thread; words are quoted as a Tcl list.
+    void post(std::vector<std::string> words);
+};
+
+#endif
@@ -0,0 +1,177 @@
+// src/ThumbnailCache.cpp
+#include "ThumbnailCache.hpp"
+#include "ChildProcess.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+ThumbnailCache::ThumbnailCache() {
+    // Leave most cores to renders and playback
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    worker_count = std::clamp(cores / 4, 1, 4);
+}
+
+void ThumbnailCache::setReadyCallback(ReadyCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ready_callback = callback;
+}
+
+void ThumbnailCache::setBudget(size_t budget_bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budget = budget_bytes;
+    evict();
+}
+
+void ThumbnailCache::setWorkers(int count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // Takes effect for workers not yet started
+    worker_count = std::max(1, count);
+}
+
+std::string ThumbnailCache::key(const Request& request) {
+    char suffix[64];
+    std::snprintf(suffix, sizeof(suffix), "@%.3f:%dx%d", request.seconds, request.width, request.height);
+    return request.video + suffix;
+}
+
+std::vector<std::string> ThumbnailCache::want(const std::vector<Request>& requests) {
+    std::vector<std::string> keys;
+    keys.reserve(requests.size());
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.clear();
+    for (const auto& request : requests) {
+        std::string request_key = key(request);
+        keys.push_back(request_key);
+        if (request.width < 1 || request.height < 1 || index.count(request_key) ||
+            in_flight.count(request_key) || failed.count(request_key)) {
+            continue;
+        }
+        pending.emplace_back(request_key, request);
+    }
+    if (stopping || pending.empty()) return keys;
+
+    while (static_cast<int>(workers.size()) < worker_count) {
+        workers.emplace_back(&ThumbnailCache::workerLoop, this);
+    }
+    work.notify_all();
+    return keys;
+}
+
+std::shared_ptr<const ThumbnailCache::Thumbnail> ThumbnailCache::get(const std::string& thumbnail_key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(thumbnail_key);
+    if (it == index.end()) return nullptr;
+    lru.splice(lru.begin(), lru, it->second);
+    hits++;
+    return it->second->second;
+}
+
+// Caller holds `mutex`
+void ThumbnailCache::evict() {
+    while (bytes > budget && !lru.empty()) {
+        bytes -= lru.back().second->rgb.size();
+        index.erase(lru.back().first);
+        lru.pop_back();
+    }
+}
+
+bool ThumbnailCache::decode(const Request& request, Thumbnail& thumbnail, std::string& error) {
+    char seconds[32];
+    std::snprintf(seconds, sizeof(seconds), "%.3f", request.seconds < 0 ? -request.seconds : request.seconds);
+    // Area averaging keeps thin LaTeX strokes visible when shrunk a lot
+    std::vector<std::string> argv = {"ffmpeg", "-nostdin", "-v", "error",
+                                     request.seconds < 0 ? "-sseof" : "-ss",
+                                     request.seconds < 0 ? std::string("-") + seconds : seconds,
+                                     "-i", request.video, "-frames:v", "1",
+                                     "-vf", "scale=" + std::to_string(request.width) + ":" +
+                                            std::to_string(request.height) + ":flags=area",
+                                     "-f", "rawvideo", "-pix_fmt", "rgb24", "-"};
+    ChildProcess child;
+    try {
+        child = spawnProcessGroup(argv);
+    } catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+    thumbnail.width = request.width;
+    thumbnail.height = request.height;
+    thumbnail.rgb.resize(static_cast<size_t>(request.width) * request.height * 3);
+    size_t got = readFully(child.out_fd, thumbnail.rgb.data(), thumbnail.rgb.size());
+    OutputRing errors(1024);
+    drainReadable(child.err_fd, &errors);
+    int status = waitProcess(child);
+    if (got < thumbnail.rgb.size()) {
+        error = "ffmpeg gave no frame (status " + std::to_string(status) + "): " + errors.str();
+        return false;
+    }
+    return true;
+}
+
+void ThumbnailCache::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (stopping) return;
+        auto [request_key, request] = pending.front();
+        pending.pop_front();
+        in_flight.insert(request_key);
+        lock.unlock();
+
+        auto thumbnail = std::make_shared<Thumbnail>();
+        std::string error;
+        bool ok = decode(request, *thumbnail, error);
+        if (!ok) std::cerr << "[C++] Thumbnail " << request_key << " failed: " << error << std::endl;
+
+        lock.lock();
+        in_flight.erase(request_key);
+        if (ok) {
+            lru.emplace_front(request_key, thumbnail);
+            index[request_key] = lru.begin();
+            bytes += thumbnail->rgb.size();
+            decoded++;
+            evict();
+        } else {
+            failed.insert(request_key);
+        }
+        ReadyCallback callback = ready_callback;
+        lock.unlock();
+        if (callback) callback(request_key, ok);
+        lock.lock();
+    }
+}
+
+ThumbnailCache::Stats ThumbnailCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats stats;
+    stats.entries = lru.size();
+    stats.bytes = bytes;
+    stats.budget = budget;
+    stats.pending = pending.size() + in_flight.size();
+    stats.hits = hits;
+    stats.decoded = decoded;
+    return stats;
+}
+
+void ThumbnailCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.clear();
+    failed.clear();
+    lru.clear();
+    index.clear();
+    bytes = 0;
+}
+
+void ThumbnailCache::shutdown() {
+    std::vector<std::thread> running;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        pending.clear();
+        running.swap(workers);
+    }
+    work.notify_all();
+    for (auto& worker : running) {
+        if (worker.joinable()) worker.join();
+    }
+}
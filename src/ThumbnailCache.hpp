@@ -0,0 +1,100 @@
+// src/ThumbnailCache.hpp
+#ifndef THUMBNAILCACHE_HPP
+#define THUMBNAILCACHE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Small RGB pictures of single video frames for the timeline. Frames are
+// decoded on a pool of worker threads, each running ffmpeg for one frame
+// and letting its scaler shrink it, and only when asked for: the GUI
+// asks for what is in view. Finished thumbnails are kept in an LRU with
+// a memory budget, so scrolling back is instant and a long timeline
+// never holds more than the budget.
+class ThumbnailCache {
+public:
+    struct Request {
+        std::string video;
+        double seconds = 0.0;   // negative: that far before the end
+        int width = 0, height = 0;
+    };
+
+    struct Thumbnail {
+        int width = 0, height = 0;
+        std::vector<unsigned char> rgb;
+    };
+
+    struct Stats {
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t budget = 0;
+        size_t pending = 0;
+        long hits = 0;
+        long decoded = 0;
+    };
+
+    // Invoked on a worker thread when a requested thumbnail is decoded
+    // (ok) or could not be
+    using ReadyCallback = std::function<void(const std::string& key, bool ok)>;
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable work;
+    std::vector<std::thread> workers;
+    int worker_count = 2;
+    bool stopping = false;
+
+    std::deque<std::pair<std::string, Request>> pending;  // in the order asked for
+    std::set<std::string> in_flight;
+    std::set<std::string> failed;                          // not asked for again
+
+    using Entry = std::pair<std::string, std::shared_ptr<const Thumbnail>>;
+    std::list<Entry> lru;                                  // most recent first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    size_t bytes = 0;
+    size_t budget = 64 * 1024 * 1024;
+    long hits = 0;
+    long decoded = 0;
+
+    ReadyCallback ready_callback;
+
+    void workerLoop();
+    void evict();  // caller holds `mutex`
+    static bool decode(const Request& request, Thumbnail& thumbnail, std::string& error);
+
+public:
+    ThumbnailCache();
+    ~ThumbnailCache() { shutdown(); }
+
+    void setReadyCallback(ReadyCallback callback);
+    void setBudget(size_t bytes);
+    void setWorkers(int count);
+
+    // Cache key of a request
+    static std::string key(const Request& request);
+
+    // Make `requests` the work to do, dropping requests no longer wanted:
+    // the visible range has moved on. Cached, failed and in-flight ones
+    // are skipped. Returns the keys, in order.
+    std::vector<std::string> want(const std::vector<Request>& requests);
+
+    // A cached thumbnail, or null; counts as a use for the LRU
+    std::shared_ptr<const Thumbnail> get(const std::string& key);
+
+    Stats stats() const;
+    void clear();
+
+    // Drop pending work and wait for the workers
+    void shutdown();
+};
+
+#endif
@@ -0,0 +1,344 @@
+// src/VideoPlayer.cpp
+#include "VideoPlayer.hpp"
+#include "Mp4Info.hpp"
+
+#include <tk.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <signal.h>
+#include <sstream>
+#include <unistd.h>
+
+bool VideoPlayer::probe(const std::string& path, Info& info, std::string& error) {
+    ProcessResult result;
+    try {
+        result = runProcess({"ffprobe", "-v", "error", "-select_streams", "v:0",
+                             "-show_entries", "stream=r_frame_rate,nb_frames:format=duration",
+                             "-of", "default=noprint_wrappers=1", path});
+    } catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+    if (!result.succeeded()) {
+        error = "ffprobe could not read " + path + ": " + result.output.str();
+        return false;
+    }
+
+    // r_frame_rate=60/1, nb_frames=150 (or N/A), duration=2.500000
+    double duration = 0.0;
+    long frames = 0;
+    std::istringstream lines(result.output.str());
+    std::string line;
+    while (std::getline(lines, line)) {
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) continue;
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+        if (key == "r_frame_rate") {
+            double numerator = 0.0, denominator = 0.0;
+            if (std::sscanf(value.c_str(), "%lf/%lf", &numerator, &denominator) == 2 && denominator > 0.0) {
+                info.fps = numerator / denominator;
+            }
+        } else if (key == "nb_frames") {
+            frames = std::strtol(value.c_str(), nullptr, 10);
+        } else if (key == "duration") {
+            duration = std::strtod(value.c_str(), nullptr);
+        }
+    }
+    if (info.fps <= 0.0) {
+        error = "No video stream in " + path;
+        return false;
+    }
+    info.frame_count = static_cast<int>(frames > 0 ? frames : std::lround(duration * info.fps));
+    return true;
+}
+
+bool VideoPlayer::open(Tcl_Interp* interp, const std::string& photo, const std::string& path,
+                       int width, int height, std::string& error, bool stream) {
+    close();
+    if (width < 2 || height < 2) {
+        error = "Player size must be at least 2x2";
+        return false;
+    }
+    Tk_PhotoHandle handle = Tk_FindPhoto(interp, photo.c_str());
+    if (!handle) {
+        error = "No photo image named \"" + photo + "\"";
+        return false;
+    }
+    Info probed;
+    if (!probe(path, probed, error)) return false;
+    probed.width = width;
+    probed.height = height;
+    if (Tk_PhotoSetSize(interp, handle, width, height) != TCL_OK) {
+        error = Tcl_GetStringResult(interp);
+        return false;
+    }
+
+    this->interp = interp;
+    this->photo = photo;
+    this->path = path;
+    info = probed;
+    {
+        std::lock_guard<std::mutex> lock(clips_mutex);
+        clips = {{path, 0, info.frame_count}};
+        streaming = stream;
+    }
+
+    // Prefetch up to two seconds of video, as far as the memory budget goes
+    size_t frame_bytes = static_cast<size_t>(width) * height * 3;
+    size_t wanted = static_cast<size_t>(std::ceil(info.fps * 2.0));
+    ring.reset(std::max<size_t>(2, std::min(wanted, prefetch_bytes / frame_bytes)));
+
+    position = 0;
+    seek(0);
+    std::cout << "[C++] Player opened " << path << ": " << info.frame_count << " frames at "
+              << info.fps << " fps, " << ring.capacity() << " frames prefetched"
+              << (stream ? ", more clips to come" : "") << std::endl;
+    return true;
+}
+
+bool VideoPlayer::append(const std::string& clip, std::string& error) {
+    if (!isOpen() || !streaming) {
+        error = "The player is not open on a stream";
+        return false;
+    }
+    // The clip's length from its header is enough to place it; only ask
+    // ffprobe when that can't be read
+    int frames;
+    double seconds = mp4Duration(clip);
+    if (seconds > 0.0) {
+        frames = static_cast<int>(std::lround(seconds * info.fps));
+    } else {
+        Info probed;
+        if (!probe(clip, probed, error)) return false;
+        frames = probed.frame_count;
+    }
+    {
+        std::lock_guard<std::mutex> lock(clips_mutex);
+        clips.push_back({clip, info.frame_count, frames});
+    }
+    info.frame_count += frames;
+    clips_changed.notify_all();
+    return true;
+}
+
+void VideoPlayer::finishStream() {
+    {
+        std::lock_guard<std::mutex> lock(clips_mutex);
+        streaming = false;
+    }
+    clips_changed.notify_all();
+}
+
+void VideoPlayer::startDecoder(int first_frame) {
+    decoder_done = false;
+    stop_decoder = false;
+    decoder_error.clear();
+    decoder = std::thread(&VideoPlayer::decodeLoop, this, first_frame);
+}
+
+void VideoPlayer::stopDecoder() {
+    if (!decoder.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(clips_mutex);
+        stop_decoder = true;
+    }
+    clips_changed.notify_all();
+    ring.close();
+    pid_t pid = decoder_pid;
+    if (pid > 0) kill(-pid, SIGKILL);
+    decoder.join();
+}
+
+void VideoPlayer::decodeLoop(int first_frame) {
+    int index = first_frame;
+    for (size_t next = 0; !stop_decoder; next++) {
+        Clip clip;
+        {
+            std::unique_lock<std::mutex> lock(clips_mutex);
+            decoder_waiting = true;
+            clips_changed.wait(lock, [&] { return stop_decoder || next < clips.size() || !streaming; });
+            decoder_waiting = false;
+            if (stop_decoder || next >= clips.size()) break;
+            clip = clips[next];
+        }
+        if (clip.first_frame + clip.frame_count <= index) continue;  // before the seek point
+
+        // A clip that was a frame short of its estimate leaves a gap
+        // rather than shifting every later frame
+        index = std::max(index, clip.first_frame);
+        if (!decodeClip(clip, index - clip.first_frame, index)) break;
+    }
+    decoder_done = true;
+}
+
+bool VideoPlayer::decodeClip(const Clip& clip, int offset, int& index) {
+    std::vector<std::string> argv = {"ffmpeg", "-nostdin", "-v", "error"};
+    if (offset > 0) {
+        // Seeking before -i is frame exact when decoding; half a frame
+        // early so rounding can't land on the frame after
+        char seconds[32];
+        std::snprintf(seconds, sizeof(seconds), "%.6f", (offset - 0.5) / info.fps);
+        argv.insert(argv.end(), {"-ss", seconds});
+    }
+    argv.insert(argv.end(), {"-i", clip.path, "-vf", "scale=" + std::to_string(info.width) + ":" +
+                             std::to_string(info.height), "-f", "rawvideo", "-pix_fmt", "rgb24", "-"});
+
+    ChildProcess child;
+    try {
+        child = spawnProcessGroup(argv);
+    } catch (const std::exception& e) {
+        decoder_error = e.what();
+        return false;
+    }
+    decoder_pid = child.pid;
+    if (stop_decoder) kill(-child.pid, SIGKILL);
+
+    size_t frame_bytes = static_cast<size_t>(info.width) * info.height * 3;
+    int first = index;
+    while (!stop_decoder) {
+        next_frame.rgb.resize(frame_bytes);
+        if (readFully(child.out_fd, next_frame.rgb.data(), frame_bytes) < frame_bytes) break;
+        next_frame.index = index++;
+        if (!ring.push(next_frame)) break;
+    }
+
+    if (stop_decoder) kill(-child.pid, SIGKILL);
+    OutputRing errors(4096);
+    drainReadable(child.err_fd, &errors);
+    int status = waitProcess(child);
+    decoder_pid = -1;
+    if (stop_decoder) return false;
+    if (index == first) {
+        decoder_error = "ffmpeg decoded no frames of " + clip.path + " (status " +
+                        std::to_string(status) + "): " + errors.str();
+        return false;
+    }
+    return true;
+}
+
+void VideoPlayer::schedule(int delay_ms) {
+    if (timer) Tcl_DeleteTimerHandler(timer);
+    timer = Tcl_CreateTimerHandler(std::max(0, delay_ms), onTimer, this);
+}
+
+void VideoPlayer::onTimer(ClientData data) {
+    VideoPlayer* self = static_cast<VideoPlayer*>(data);
+    self->timer = nullptr;
+    self->tick();
+}
+
+void VideoPlayer::tick() {
+    using Clock = std::chrono::steady_clock;
+    if (!isOpen() || (!playing && target < 0)) return;
+
+    // Check "done" before popping: a frame pushed in between is then
+    // still seen on the next tick
+    bool decoder_finished = decoder_done;
+    if (!ring.pop(frame)) {
+        if (!decoder_finished) {
+            // The decoder fell behind, or is waiting for the next clip of
+            // a stream; carry on from wherever it is rather than skip frames
+            clock_frame = -1;
+            schedule(decoder_waiting ? 50 : 5);
+            return;
+        }
+        if (!decoder_error.empty()) {
+            std::cerr << "[C++] Player: " << decoder_error << std::endl;
+            decoder_error.clear();
+        }
+        target = -1;
+        if (playing) {
+            playing = false;
+            if (end_callback) end_callback();
+        }
+        return;
+    }
+
+    if (!draw(frame)) return;
+    position = frame.index;
+    target = -1;
+    if (frame_callback) frame_callback(position, info.frame_count);
+    if (!playing) return;
+
+    // Frame n is due at clock_start + (n - clock_frame) / fps. Restart the
+    // clock after a seek, a stall, or when more than 100 ms behind.
+    Clock::time_point now = Clock::now();
+    if (clock_frame < 0) {
+        clock_start = now;
+        clock_frame = position;
+    }
+    auto due = clock_start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>((position + 1 - clock_frame) / info.fps));
+    if (now - due > std::chrono::milliseconds(100)) {
+        clock_start = now;
+        clock_frame = position + 1;
+        due = now;
+    }
+    schedule(static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count()));
+}
+
+bool VideoPlayer::draw(const VideoFrame& frame) {
+    Tk_PhotoHandle handle = Tk_FindPhoto(interp, photo.c_str());
+    if (!handle) {
+        // The image was deleted under us
+        close();
+        return false;
+    }
+    Tk_PhotoImageBlock block;
+    block.pixelPtr = const_cast<unsigned char*>(frame.rgb.data());
+    block.width = info.width;
+    block.height = info.height;
+    block.pitch = info.width * 3;
+    block.pixelSize = 3;
+    block.offset[0] = 0;
+    block.offset[1] = 1;
+    block.offset[2] = 2;
+    block.offset[3] = 3;  // past the pixel: no alpha
+    return Tk_PhotoPutBlock(interp, handle, &block, 0, 0, info.width, info.height,
+                            TK_PHOTO_COMPOSITE_SET) == TCL_OK;
+}
+
+void VideoPlayer::play() {
+    if (!isOpen() || playing) return;
+    // From the top again once the end was reached
+    if (decoder_done && ring.size() == 0 && target < 0) seek(0);
+    playing = true;
+    clock_frame = -1;
+    schedule(0);
+}
+
+void VideoPlayer::pause() {
+    playing = false;
+}
+
+void VideoPlayer::seek(int frame_index) {
+    if (!isOpen()) return;
+    if (info.frame_count > 0) frame_index = std::min(frame_index, info.frame_count - 1);
+    frame_index = std::max(0, frame_index);
+
+    stopDecoder();
+    ring.reset(ring.capacity());
+    startDecoder(frame_index);
+    target = frame_index;
+    clock_frame = -1;
+    schedule(0);
+}
+
+void VideoPlayer::close() {
+    if (timer) {
+        Tcl_DeleteTimerHandler(timer);
+        timer = nullptr;
+    }
+    stopDecoder();
+    playing = false;
+    target = -1;
+    path.clear();
+    std::lock_guard<std::mutex> lock(clips_mutex);
+    clips.clear();
+    streaming = false;
+}
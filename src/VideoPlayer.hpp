@@ -0,0 +1,140 @@
+// src/VideoPlayer.hpp
+#ifndef VIDEOPLAYER_HPP
+#define VIDEOPLAYER_HPP
+
+#include <tcl.h>
+
+#include "ChildProcess.hpp"
+#include "FrameRing.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Plays a rendered video inside the app by drawing its frames into a Tk
+// photo image. A decoder thread pipes raw RGB frames out of ffmpeg,
+// scaled to the player size, into a ring buffer ahead of playback; a Tcl
+// timer on the interpreter thread shows each one when it is due, so
+// playback keeps the video's frame rate. Seeking restarts the decoder at
+// the exact frame asked for.
+//
+// A video can also be a stream of clips played back to back, such as the
+// segments of a render still in progress: clips are appended while it
+// plays, and playback waits at the end of the last one until the next
+// arrives or the stream is finished.
+class VideoPlayer {
+public:
+    struct Info {
+        int frame_count = 0;        // of all the clips so far
+        double fps = 0.0;
+        int width = 0, height = 0;  // of the decoded frames
+    };
+
+    // Invoked on the interpreter thread after a frame is drawn
+    using FrameCallback = std::function<void(int frame, int frame_count)>;
+    // Invoked on the interpreter thread when playback reaches the end
+    using EndCallback = std::function<void()>;
+
+private:
+    // One file of the video and where it starts
+    struct Clip {
+        std::string path;
+        int first_frame = 0;
+        int frame_count = 0;
+    };
+
+    Tcl_Interp* interp = nullptr;
+    std::string photo;       // Tk photo image the frames go into
+    std::string path;        // of the first clip
+    Info info;
+
+    std::mutex clips_mutex;  // the decoder reads clips as they are appended
+    std::condition_variable clips_changed;
+    std::vector<Clip> clips;
+    bool streaming = false;  // more clips may be appended
+    size_t prefetch_bytes = 64 * 1024 * 1024;
+
+    FrameRing ring;
+    std::thread decoder;
+    std::atomic<bool> decoder_done{false};
+    std::atomic<bool> stop_decoder{false};
+    std::atomic<pid_t> decoder_pid{-1};
+    std::atomic<bool> decoder_waiting{false};  // for a clip not appended yet
+    std::string decoder_error;  // written by the decoder, read after join
+
+    VideoFrame frame;        // the frame on screen, or being swapped in
+    VideoFrame next_frame;   // the decoder's spare, being filled
+    int position = 0;        // index of the frame on screen
+    int target = -1;         // paused: frame to show once decoded
+    bool playing = false;
+    Tcl_TimerToken timer = nullptr;
+
+    // Wall clock time `clock_frame` is (was) due at
+    std::chrono::steady_clock::time_point clock_start;
+    int clock_frame = 0;
+
+    FrameCallback frame_callback;
+    EndCallback end_callback;
+
+    static bool probe(const std::string& path, Info& info, std::string& error);
+    void startDecoder(int first_frame);
+    void stopDecoder();
+    void decodeLoop(int first_frame);
+    // Decode `clip` from `offset` frames in, numbering frames from `index`
+    // on; false if the decoder is stopping or the clip gave no frames
+    bool decodeClip(const Clip& clip, int offset, int& index);
+    void schedule(int delay_ms);
+    static void onTimer(ClientData data);
+    void tick();
+    bool draw(const VideoFrame& frame);
+
+public:
+    VideoPlayer() = default;
+    ~VideoPlayer() { close(); }
+
+    VideoPlayer(const VideoPlayer&) = delete;
+    VideoPlayer& operator=(const VideoPlayer&) = delete;
+
+    void setFrameCallback(FrameCallback callback) { frame_callback = callback; }
+    void setEndCallback(EndCallback callback) { end_callback = callback; }
+
+    // Memory the prefetched frames may take
+    void setPrefetchBytes(size_t bytes) { prefetch_bytes = bytes; }
+
+    // Load `path` for playback into the existing photo image `photo`, at
+    // width x height, and show its first frame. Must be called on the
+    // interpreter thread.
+    // With `stream`, `path` is only the first clip; see append().
+    bool open(Tcl_Interp* interp, const std::string& photo, const std::string& path,
+              int width, int height, std::string& error, bool stream = false);
+
+    // Add the next clip of a stream opened with `stream`. The clips must
+    // share the first one's frame rate.
+    bool append(const std::string& clip, std::string& error);
+
+    // No more clips are coming; playback ends after the last one
+    void finishStream();
+
+    void play();
+    void pause();
+
+    // Show frame `frame` (clamped to the video); keeps playing if it was
+    void seek(int frame);
+
+    // Stop decoding and let go of the video; the photo keeps the last frame
+    void close();
+
+    bool isOpen() const { return !path.empty(); }
+    bool isPlaying() const { return playing; }
+    bool isStreaming() const { return streaming; }
+    int currentFrame() const { return position; }
+    const Info& videoInfo() const { return info; }
+    const std::string& videoPath() const { return path; }
+};
+
+#endif
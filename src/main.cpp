@@ -4,6 +4,7 @@
 
 #include <fstream>
 #include <cstdlib>
+#include <cstdio>
 #include <array>
 #include <memory>
 #include <vector>
@@ -14,37 +15,51 @@
 #include "SceneManager.hpp"
 
 #include "HandwritingRenderer.hpp"
+#include "JsonUtil.hpp"
+#include "LatexValidator.hpp"
+#include "ManimScript.hpp"
+#include "PreviewScheduler.hpp"
+#include "RenderManager.hpp"
+#include "TclEventBridge.hpp"
+#include "ThumbnailCache.hpp"
+#include "VideoPlayer.hpp"
 #include <thread>
 #include <chrono>
-
-// Global storage for equations
-std::vector<MathEquation> equations;
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <sstream>
 
 // Global scene manager
 SceneManager sceneManager;
 
+// Background renders and the queue that reports back to the Tk thread
+RenderManager renderManager;
+TclEventBridge tclEventBridge;
 
+// Still-frame previews rendered after each scene edit
+PreviewScheduler previewScheduler(renderManager, sceneManager);
+
+// Plays finished renders on the canvas
+VideoPlayer videoPlayer;
+
+// Per-animation pictures for the timeline strip
+ThumbnailCache thumbnailCache;
 
-// Add this struct for render options
-struct RenderOptions {
-    std::string quality = "-ql";  // -ql (low), -qm (medium), -qh (high)
-    std::string filename = "render_output";
-    bool open_after_render = false;
-};
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-std::string execCommand(const std::string& cmd) {
-    std::array<char, 128> buffer;
-    std::string result;
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
-    
-    if (!pipe) return "Error executing command";
-    
-    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-        result += buffer.data();
+// Run a program (no shell) and return the tail of its output
+std::string execCommand(const std::vector<std::string>& argv) {
+    try {
+        ProcessResult result = runProcess(argv);
+        std::cout << "[C++] " << commandLine(argv) << ": " << result.describe() << std::endl;
+        return result.output.str();
+    } catch (const std::exception& e) {
+        return "Error executing command: " + std::string(e.what());
     }
-    
-    return result;
 }
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Example C++ function that will become a Tcl command
@@ -76,113 +91,838 @@ int AddNumbers_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj*
     return TCL_OK;
 }
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// The main render function that Tcl calls
+// The ?--animations first last? ?--seconds from to? options of render_scene
+// and render_estimate, from objv[start] on
+int parseRenderRange(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[], int start,
+                     const std::vector<MathEquation>& equations, RenderOptions& options) {
+    int count = static_cast<int>(equations.size());
+    for (int i = start; i < objc; i += 3) {
+        std::string option = Tcl_GetString(objv[i]);
+        if ((option != "--animations" && option != "--seconds") || i + 2 >= objc) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("bad option \"%s\": must be --animations first last or --seconds from to",
+                                                   option.c_str()));
+            return TCL_ERROR;
+        }
+        if (option == "--animations") {
+            int first, last;
+            if (Tcl_GetIntFromObj(interp, objv[i + 1], &first) != TCL_OK ||
+                Tcl_GetIntFromObj(interp, objv[i + 2], &last) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (first < 1 || last < first || last > count) {
+                Tcl_SetObjResult(interp, Tcl_ObjPrintf("animations must be a range within 1..%d", count));
+                return TCL_ERROR;
+            }
+            options.first_animation = first - 1;
+            options.last_animation = last - 1;
+        } else {
+            double from, to;
+            if (Tcl_GetDoubleFromObj(interp, objv[i + 1], &from) != TCL_OK ||
+                Tcl_GetDoubleFromObj(interp, objv[i + 2], &to) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (count == 0 || from < 0.0 || to <= from) {
+                Tcl_SetObjResult(interp, Tcl_NewStringObj("seconds must be a range from 0 on in a scene with equations", -1));
+                return TCL_ERROR;
+            }
+            // An animation ending exactly at `to` is the last one in it
+            options.first_animation = ManimScript::animationAt(equations, from);
+            options.last_animation = ManimScript::animationAt(equations, std::nextafter(to, from));
+        }
+    }
+    return TCL_OK;
+}
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// One dict per asset: ?quality? node hash rebuild reason
+Tcl_Obj* assetDecisionList(Tcl_Interp* interp, const std::vector<AssetDecision>& assets, const std::string& quality = "") {
+    Tcl_Obj* list = Tcl_NewListObj(0, nullptr);
+    for (const auto& asset : assets) {
+        Tcl_Obj* dict = Tcl_NewDictObj();
+        if (!quality.empty()) {
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("quality", -1), Tcl_NewStringObj(quality.c_str(), -1));
+        }
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("node", -1), Tcl_NewStringObj(asset.node.c_str(), -1));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("hash", -1), Tcl_NewStringObj(asset.hash.c_str(), -1));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("rebuild", -1), Tcl_NewBooleanObj(asset.rebuild));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("reason", -1), Tcl_NewStringObj(asset.reason.c_str(), -1));
+        Tcl_ListObjAppendElement(interp, list, dict);
+    }
+    return list;
+}
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The main render function that Tcl calls. The render itself is queued on
+// the RenderManager; this returns the job id straight away and the GUI is
+// told about completion through render_job_finished. Priority is preview,
+// normal (the default), export, background or an integer; higher starts
+// first. Quality "progressive" renders a -ql draft and then a -qh version
+// in the background, and returns both job ids.
+//
+// --animations first last renders only those animations (counted from 1,
+// as on the timeline) and --seconds from to the ones playing in that part
+// of the full video; the scene is set up as it stands before the range
+// without animating it.
+//
+// --explain renders nothing and returns what the render would rebuild:
+// one dict per asset (see AssetGraph) with quality, node, hash, rebuild
+// and the reason, e.g. {node {segment 3} rebuild 1 reason {equation 3
+// changed}}. A progressive render lists its -ql assets, then its -qh ones.
 int RenderScene_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
     std::cout << "[C++] RenderScene_CPP called with " << objc << " arguments" << std::endl;
     
+    // Positional arguments come first, then the range options
+    int positional = 1;
+    while (positional < objc && std::string(Tcl_GetString(objv[positional])).compare(0, 2, "--") != 0) {
+        positional++;
+    }
+    if (positional > 4) {
+        Tcl_WrongNumArgs(interp, 1, objv, "?quality? ?filename? ?priority? ?--animations first last? ?--seconds from to? ?--explain?");
+        return TCL_ERROR;
+    }
+    
+    // --explain takes no value, unlike the range options
+    std::vector<Tcl_Obj*> args(objv, objv + objc);
+    bool explain = false;
+    for (auto it = args.begin() + positional; it != args.end();) {
+        if (std::string(Tcl_GetString(*it)) != "--explain") {
+            ++it;
+            continue;
+        }
+        explain = true;
+        it = args.erase(it);
+    }
+    
     // Parse optional arguments
     RenderOptions options;
-    if (objc > 1) {
+    if (positional > 1) {
         options.quality = Tcl_GetString(objv[1]);
-        if (objc > 2) {
+        if (positional > 2) {
             options.filename = Tcl_GetString(objv[2]);
         }
+        if (positional > 3 && !parseRenderPriority(Tcl_GetString(objv[3]), options.priority)) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("bad priority \"%s\": must be preview, normal, export, background or an integer",
+                                                   Tcl_GetString(objv[3])));
+            return TCL_ERROR;
+        }
     }
     
-    try {
-        // 1. Generate the Manim Python script
-        std::string script_path = options.filename + ".py";
-        std::cout << "[C++] Generating script: " << script_path << std::endl;
-        
-        std::ofstream manim_script(script_path);
-        if (!manim_script.is_open()) {
-            throw std::runtime_error("Could not open script file for writing");
+    std::vector<MathEquation> equations = sceneManager.snapshot();
+    if (parseRenderRange(interp, static_cast<int>(args.size()), args.data(), positional, equations, options) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    
+    if (explain) {
+        std::vector<std::string> qualities = {options.quality};
+        if (options.quality == "progressive") qualities = {"-ql", "-qh"};
+        Tcl_Obj* list = Tcl_NewListObj(0, nullptr);
+        for (const auto& quality : qualities) {
+            options.quality = quality;
+            Tcl_ListObjAppendList(interp, list, assetDecisionList(interp, renderManager.explain(options, equations), quality));
         }
-        
-        // Write the Manim script header
-        manim_script << "from manim import *\n\n";
-        manim_script << "class GeneratedScene(Scene):\n";
-        manim_script << "    def construct(self):\n";
-        
-        // Check if we have equations to render
-        if (equations.empty()) {
-            manim_script << "        # No equations to render\n";
-            manim_script << "        text = Text(\"No equations in scene\", font_size=24)\n";
-            manim_script << "        self.play(Write(text))\n";
-            manim_script << "        self.wait(1)\n";
-        } else {
-            // Add each equation to the script
-            std::cout << "[C++] Adding " << equations.size() << " equations to script" << std::endl;
+        Tcl_SetObjResult(interp, list);
+        return TCL_OK;
+    }
+    
+    // Fail here rather than seconds later inside Manim
+    std::string errors;
+    for (const auto& eq : equations) {
+        for (const auto& issue : LatexValidator::check(eq.latex)) {
+            if (issue.severity != LatexIssue::Error) continue;
+            errors += "\nEq#" + std::to_string(eq.id) + " " + LatexValidator::describe(issue);
+        }
+    }
+    if (!errors.empty()) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(("Invalid LaTeX in scene:" + errors).c_str(), -1));
+        return TCL_ERROR;
+    }
+    
+    if (options.quality == "progressive") {
+        auto [draft_id, final_id] = renderManager.submitProgressive(options, std::move(equations));
+        Tcl_Obj* ids[2] = {Tcl_NewIntObj(draft_id), Tcl_NewIntObj(final_id)};
+        Tcl_SetObjResult(interp, Tcl_NewListObj(2, ids));
+        return TCL_OK;
+    }
+    
+    int job_id = renderManager.submit(options, std::move(equations));
+    
+    Tcl_SetObjResult(interp, Tcl_NewIntObj(job_id));
+    return TCL_OK;
+}
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// How long render_scene would take right now, without rendering:
+//   render_estimate ?quality? ?--animations first last? ?--seconds from to?
+// Returns a dict: seconds (-1 while there are no renders to go by), samples
+// (renders it is based on), basis (model, rate, scaled, cache or none), and
+// what it was estimated from: animations, writes, transforms, tex_tokens
+// and cached, counted after the render and segment caches.
+int RenderEstimate_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    int positional = 1;
+    while (positional < objc && std::string(Tcl_GetString(objv[positional])).compare(0, 2, "--") != 0) {
+        positional++;
+    }
+    if (positional > 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "?quality? ?--animations first last? ?--seconds from to?");
+        return TCL_ERROR;
+    }
+    
+    RenderOptions options;
+    if (positional > 1) options.quality = Tcl_GetString(objv[1]);
+    if (options.quality == "progressive") {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("estimate the -ql draft and the -qh render of a progressive render separately", -1));
+        return TCL_ERROR;
+    }
+    std::vector<MathEquation> equations = sceneManager.snapshot();
+    if (parseRenderRange(interp, objc, objv, positional, equations, options) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    
+    RenderWork work;
+    RenderEstimator::Estimate estimate = renderManager.estimate(options, std::move(equations), work);
+    Tcl_Obj* dict = Tcl_NewDictObj();
+    Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("seconds", -1), Tcl_NewDoubleObj(estimate.seconds));
+    Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("samples", -1), Tcl_NewIntObj(estimate.samples));
+    Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("basis", -1), Tcl_NewStringObj(estimate.basis.c_str(), -1));
+    Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("animations", -1), Tcl_NewIntObj(work.animations));
+    Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("writes", -1), Tcl_NewIntObj(work.writes));
+    Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("transforms", -1), Tcl_NewIntObj(work.transforms));
+    Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("tex_tokens", -1), Tcl_NewIntObj(work.tex_tokens));
+    Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("cached", -1), Tcl_NewBooleanObj(work.cached));
+    Tcl_SetObjResult(interp, dict);
+    return TCL_OK;
+}
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Cancel a running render: kills Manim and everything it spawned
+int CancelRender_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    if (objc != 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "job_id");
+        return TCL_ERROR;
+    }
+    
+    int job_id;
+    if (Tcl_GetIntFromObj(interp, objv[1], &job_id) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    
+    Tcl_SetObjResult(interp, Tcl_NewBooleanObj(renderManager.cancel(job_id)));
+    return TCL_OK;
+}
+
+// Inspect and manage the on-disk render cache:
+//   render_cache stats | clear | limit ?megabytes? | enable ?boolean? | segments ?boolean?
+// The limit applies to whole videos and per-animation segments separately.
+int RenderCache_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    static const char* subcommands[] = {"stats", "clear", "limit", "enable", "segments", nullptr};
+    enum { CACHE_STATS, CACHE_CLEAR, CACHE_LIMIT, CACHE_ENABLE, CACHE_SEGMENTS };
+    
+    int index;
+    if (objc < 2 || objc > 3) {
+        Tcl_WrongNumArgs(interp, 1, objv, "stats|clear|limit|enable|segments ?value?");
+        return TCL_ERROR;
+    }
+    if (Tcl_GetIndexFromObj(interp, objv[1], subcommands, "subcommand", 0, &index) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    
+    RenderCache& cache = renderManager.cache();
+    RenderCache& segments = renderManager.segmentCache();
+    switch (index) {
+        case CACHE_STATS: {
+            RenderCache::Stats stats = cache.stats();
+            Tcl_Obj* dict = Tcl_NewDictObj();
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("entries", -1), Tcl_NewWideIntObj(stats.entries));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("bytes", -1), Tcl_NewWideIntObj(stats.bytes));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("hits", -1), Tcl_NewWideIntObj(stats.hits));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("misses", -1), Tcl_NewWideIntObj(stats.misses));
             
-            for (size_t i = 0; i < equations.size(); i++) {
-                const auto& eq = equations[i];
-                
-                manim_script << "        # Equation " << i << "\n";
-                manim_script << "        eq" << i << " = MathTex(r\"" 
-                            << eq.latex << "\")\n";
-                manim_script << "        eq" << i << ".move_to([" 
-                            << eq.x << ", " << eq.y << ", 0])\n";
-                manim_script << "        eq" << i << ".set_color(\"" 
-                            << eq.color << "\")\n";
-                manim_script << "        eq" << i << ".scale(" 
-                            << eq.scale << ")\n";
-                
-                // Different animation based on position
-                if (i == 0) {
-                    manim_script << "        self.play(Write(eq" << i << "))\n";
-                } else {
-                    manim_script << "        self.play(TransformFromCopy(eq" << (i-1) << ", eq" << i << "))\n";
+            RenderCache::Stats segment_stats = segments.stats();
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("segment_entries", -1), Tcl_NewWideIntObj(segment_stats.entries));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("segment_bytes", -1), Tcl_NewWideIntObj(segment_stats.bytes));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("segment_hits", -1), Tcl_NewWideIntObj(segment_stats.hits));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("segment_misses", -1), Tcl_NewWideIntObj(segment_stats.misses));
+            Tcl_SetObjResult(interp, dict);
+            break;
+        }
+        case CACHE_CLEAR:
+            cache.clear();
+            segments.clear();
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("Render cache cleared", -1));
+            break;
+        case CACHE_LIMIT:
+            if (objc == 3) {
+                Tcl_WideInt megabytes;
+                if (Tcl_GetWideIntFromObj(interp, objv[2], &megabytes) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                cache.setMaxBytes(static_cast<uintmax_t>(megabytes < 0 ? 0 : megabytes) << 20);
+                segments.setMaxBytes(cache.maxBytes());
+            }
+            Tcl_SetObjResult(interp, Tcl_NewWideIntObj(static_cast<Tcl_WideInt>(cache.maxBytes() >> 20)));
+            break;
+        case CACHE_ENABLE:
+            if (objc == 3) {
+                int enabled;
+                if (Tcl_GetBooleanFromObj(interp, objv[2], &enabled) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                renderManager.setCacheEnabled(enabled);
+            }
+            Tcl_SetObjResult(interp, Tcl_NewBooleanObj(renderManager.cacheEnabled()));
+            break;
+        case CACHE_SEGMENTS:
+            if (objc == 3) {
+                int enabled;
+                if (Tcl_GetBooleanFromObj(interp, objv[2], &enabled) != TCL_OK) {
+                    return TCL_ERROR;
                 }
-                manim_script << "        self.wait(0.5)\n\n";
+                renderManager.setSegmentCacheEnabled(enabled);
             }
+            Tcl_SetObjResult(interp, Tcl_NewBooleanObj(renderManager.segmentCacheEnabled()));
+            break;
+    }
+    return TCL_OK;
+}
+
+// Inspect and reorder the render queue:
+//   render_queue list | cancel job_id | reprioritize job_id priority | limit ?jobs?
+// list returns one dict per running or waiting job, running first and the
+// rest by priority; "after" is the job a waiting one depends on, or 0.
+int RenderQueue_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    static const char* subcommands[] = {"list", "cancel", "reprioritize", "limit", nullptr};
+    enum { QUEUE_LIST, QUEUE_CANCEL, QUEUE_REPRIORITIZE, QUEUE_LIMIT };
+    
+    int index;
+    if (objc < 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "list|cancel|reprioritize|limit ?arg ...?");
+        return TCL_ERROR;
+    }
+    if (Tcl_GetIndexFromObj(interp, objv[1], subcommands, "subcommand", 0, &index) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    
+    switch (index) {
+        case QUEUE_LIST: {
+            if (objc != 2) {
+                Tcl_WrongNumArgs(interp, 2, objv, nullptr);
+                return TCL_ERROR;
+            }
+            Tcl_Obj* list = Tcl_NewListObj(0, nullptr);
+            int position = 0;
+            for (const RenderJob& job : renderManager.queueSnapshot()) {
+                Tcl_Obj* dict = Tcl_NewDictObj();
+                Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("id", -1), Tcl_NewIntObj(job.id));
+                Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("state", -1), Tcl_NewStringObj(renderStateName(job.state), -1));
+                Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("priority", -1), Tcl_NewIntObj(job.options.priority));
+                Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("position", -1), Tcl_NewIntObj(position++));
+                Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("quality", -1), Tcl_NewStringObj(job.options.quality.c_str(), -1));
+                Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("equations", -1), Tcl_NewWideIntObj(job.equations.size()));
+                Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("after", -1), Tcl_NewIntObj(job.depends_on));
+                Tcl_ListObjAppendElement(interp, list, dict);
+            }
+            Tcl_SetObjResult(interp, list);
+            break;
         }
-        
-        manim_script.close();
-        std::cout << "[C++] Script generated successfully" << std::endl;
-        
-        // 2. Execute Manim
-        std::string command = "python -m manim " + script_path + " " + options.quality + " 2>&1";
-        std::cout << "[C++] Executing: " << command << std::endl;
-        
-        // Execute and capture output
-        std::array<char, 128> buffer;
-        std::string result;
-        std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(command.c_str(), "r"), pclose);
-        
-        if (!pipe) {
-            throw std::runtime_error("Failed to execute manim command");
+        case QUEUE_CANCEL: {
+            int job_id;
+            if (objc != 3) {
+                Tcl_WrongNumArgs(interp, 2, objv, "job_id");
+                return TCL_ERROR;
+            }
+            if (Tcl_GetIntFromObj(interp, objv[2], &job_id) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            Tcl_SetObjResult(interp, Tcl_NewBooleanObj(renderManager.cancel(job_id)));
+            break;
         }
-        
-        while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-            result += buffer.data();
+        case QUEUE_REPRIORITIZE: {
+            int job_id, priority;
+            if (objc != 4) {
+                Tcl_WrongNumArgs(interp, 2, objv, "job_id priority");
+                return TCL_ERROR;
+            }
+            if (Tcl_GetIntFromObj(interp, objv[2], &job_id) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (!parseRenderPriority(Tcl_GetString(objv[3]), priority)) {
+                Tcl_SetObjResult(interp, Tcl_ObjPrintf("bad priority \"%s\": must be preview, normal, export, background or an integer",
+                                                       Tcl_GetString(objv[3])));
+                return TCL_ERROR;
+            }
+            Tcl_SetObjResult(interp, Tcl_NewBooleanObj(renderManager.reprioritize(job_id, priority)));
+            break;
         }
-        
-        // Check if render was successful
-        if (result.find("File ready at") != std::string::npos) {
-            std::cout << "[C++] Render successful!" << std::endl;
-            
-            // Extract video path from output
-            size_t pos = result.find("File ready at");
-            if (pos != std::string::npos) {
-                std::string video_path = result.substr(pos + 13);
-                // Trim newlines
-                video_path.erase(video_path.find_last_not_of("\n\r") + 1);
-                std::cout << "[C++] Video: " << video_path << std::endl;
+        case QUEUE_LIMIT:
+            if (objc > 3) {
+                Tcl_WrongNumArgs(interp, 2, objv, "?jobs?");
+                return TCL_ERROR;
             }
-            
-            Tcl_SetObjResult(interp, Tcl_NewStringObj("✓ Video rendered successfully!", -1));
-            return TCL_OK;
+            if (objc == 3) {
+                int jobs;
+                if (Tcl_GetIntFromObj(interp, objv[2], &jobs) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                renderManager.setMaxConcurrent(jobs);
+            }
+            Tcl_SetObjResult(interp, Tcl_NewIntObj(renderManager.maxConcurrent()));
+            break;
+    }
+    return TCL_OK;
+}
+
+// Control the automatic still-frame preview:
+//   render_preview now | enable ?boolean? | delay ?ms? | size ?width height?
+// Finished previews arrive as render_preview_finished.
+int RenderPreview_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    static const char* subcommands[] = {"now", "enable", "delay", "size", nullptr};
+    enum { PREVIEW_NOW, PREVIEW_ENABLE, PREVIEW_DELAY, PREVIEW_SIZE };
+    
+    int index;
+    if (objc < 2 || objc > 4) {
+        Tcl_WrongNumArgs(interp, 1, objv, "now|enable|delay|size ?value ...?");
+        return TCL_ERROR;
+    }
+    if (Tcl_GetIndexFromObj(interp, objv[1], subcommands, "subcommand", 0, &index) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    
+    switch (index) {
+        case PREVIEW_NOW:
+            previewScheduler.renderNow();
+            Tcl_SetObjResult(interp, Tcl_NewIntObj(previewScheduler.currentJob()));
+            break;
+        case PREVIEW_ENABLE:
+            if (objc == 3) {
+                int enabled;
+                if (Tcl_GetBooleanFromObj(interp, objv[2], &enabled) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                previewScheduler.setEnabled(enabled);
+            }
+            Tcl_SetObjResult(interp, Tcl_NewBooleanObj(previewScheduler.isEnabled()));
+            break;
+        case PREVIEW_DELAY:
+            if (objc == 3) {
+                int ms;
+                if (Tcl_GetIntFromObj(interp, objv[2], &ms) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                previewScheduler.setDelay(ms);
+            }
+            Tcl_SetObjResult(interp, Tcl_NewIntObj(previewScheduler.delay()));
+            break;
+        case PREVIEW_SIZE: {
+            if (objc == 3) {
+                Tcl_WrongNumArgs(interp, 2, objv, "?width height?");
+                return TCL_ERROR;
+            }
+            if (objc == 4) {
+                int width, height;
+                if (Tcl_GetIntFromObj(interp, objv[2], &width) != TCL_OK ||
+                    Tcl_GetIntFromObj(interp, objv[3], &height) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                previewScheduler.setSize(width, height);
+            }
+            Tcl_Obj* size = Tcl_NewListObj(0, nullptr);
+            Tcl_ListObjAppendElement(interp, size, Tcl_NewIntObj(previewScheduler.previewWidth()));
+            Tcl_ListObjAppendElement(interp, size, Tcl_NewIntObj(previewScheduler.previewHeight()));
+            Tcl_SetObjResult(interp, size);
+            break;
+        }
+    }
+    return TCL_OK;
+}
+
+// Play a rendered video into a Tk photo image:
+//   video_player open path photo width height ?-stream? | append clip | finish |
+//                play | pause | seek frame | close | state
+// open returns {frames N fps F width W height H} and shows frame 0; state
+// returns {path P frame N frames N fps F playing B streaming B}. With
+// -stream, path is the first clip of a video still being rendered: append
+// adds the next clip and finish says there are no more. Shown frames are
+// reported as player_frame_shown frame frame_count and the end of the
+// video as player_finished.
+int VideoPlayer_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    static const char* subcommands[] = {"open", "append", "finish", "play", "pause", "seek", "close", "state", nullptr};
+    enum { PLAYER_OPEN, PLAYER_APPEND, PLAYER_FINISH, PLAYER_PLAY, PLAYER_PAUSE, PLAYER_SEEK, PLAYER_CLOSE, PLAYER_STATE };
+    static const int arg_counts[] = {6, 3, 2, 2, 2, 3, 2, 2};
+    static const char* arg_usage[] = {"path photo width height ?-stream?", "clip", nullptr, nullptr, nullptr,
+                                      "frame", nullptr, nullptr};
+    
+    int index;
+    if (objc < 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "open|append|finish|play|pause|seek|close|state ?arg ...?");
+        return TCL_ERROR;
+    }
+    if (Tcl_GetIndexFromObj(interp, objv[1], subcommands, "subcommand", 0, &index) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    bool stream = index == PLAYER_OPEN && objc == 7 && std::string(Tcl_GetString(objv[6])) == "-stream";
+    if (objc != arg_counts[index] + (stream ? 1 : 0)) {
+        Tcl_WrongNumArgs(interp, 2, objv, arg_usage[index]);
+        return TCL_ERROR;
+    }
+    
+    switch (index) {
+        case PLAYER_OPEN: {
+            int width, height;
+            if (Tcl_GetIntFromObj(interp, objv[4], &width) != TCL_OK ||
+                Tcl_GetIntFromObj(interp, objv[5], &height) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            std::string error;
+            if (!videoPlayer.open(interp, Tcl_GetString(objv[3]), Tcl_GetString(objv[2]), width, height,
+                                  error, stream)) {
+                Tcl_SetObjResult(interp, Tcl_NewStringObj(error.c_str(), -1));
+                return TCL_ERROR;
+            }
+            const VideoPlayer::Info& info = videoPlayer.videoInfo();
+            Tcl_Obj* dict = Tcl_NewDictObj();
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("frames", -1), Tcl_NewIntObj(info.frame_count));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("fps", -1), Tcl_NewDoubleObj(info.fps));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("width", -1), Tcl_NewIntObj(info.width));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("height", -1), Tcl_NewIntObj(info.height));
+            Tcl_SetObjResult(interp, dict);
+            break;
+        }
+        case PLAYER_APPEND: {
+            std::string error;
+            if (!videoPlayer.append(Tcl_GetString(objv[2]), error)) {
+                Tcl_SetObjResult(interp, Tcl_NewStringObj(error.c_str(), -1));
+                return TCL_ERROR;
+            }
+            Tcl_SetObjResult(interp, Tcl_NewIntObj(videoPlayer.videoInfo().frame_count));
+            break;
+        }
+        case PLAYER_FINISH:
+            videoPlayer.finishStream();
+            break;
+        case PLAYER_PLAY:
+            videoPlayer.play();
+            break;
+        case PLAYER_PAUSE:
+            videoPlayer.pause();
+            break;
+        case PLAYER_SEEK: {
+            int frame;
+            if (Tcl_GetIntFromObj(interp, objv[2], &frame) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            videoPlayer.seek(frame);
+            break;
+        }
+        case PLAYER_CLOSE:
+            videoPlayer.close();
+            break;
+        case PLAYER_STATE: {
+            Tcl_Obj* dict = Tcl_NewDictObj();
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("path", -1), Tcl_NewStringObj(videoPlayer.videoPath().c_str(), -1));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("frame", -1), Tcl_NewIntObj(videoPlayer.currentFrame()));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("frames", -1), Tcl_NewIntObj(videoPlayer.videoInfo().frame_count));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("fps", -1), Tcl_NewDoubleObj(videoPlayer.videoInfo().fps));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("playing", -1), Tcl_NewBooleanObj(videoPlayer.isPlaying()));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("streaming", -1), Tcl_NewBooleanObj(videoPlayer.isStreaming()));
+            Tcl_SetObjResult(interp, dict);
+            break;
+        }
+    }
+    return TCL_OK;
+}
+
+// Timeline thumbnails, decoded in the background on request:
+//   timeline_thumbnail want {{video seconds} ...} width height | put key photo |
+//                      budget ?megabytes? | stats | clear
+// want replaces the outstanding requests and returns one key per
+// {video seconds} pair (negative seconds count from the end). Each one
+// decoded is announced as timeline_thumbnail_ready key ok. put copies a
+// cached thumbnail into a photo image and returns 1, or 0 if it is not
+// cached (any more).
+int TimelineThumbnail_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    static const char* subcommands[] = {"want", "put", "budget", "stats", "clear", nullptr};
+    enum { THUMB_WANT, THUMB_PUT, THUMB_BUDGET, THUMB_STATS, THUMB_CLEAR };
+    
+    int index;
+    if (objc < 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "want|put|budget|stats|clear ?arg ...?");
+        return TCL_ERROR;
+    }
+    if (Tcl_GetIndexFromObj(interp, objv[1], subcommands, "subcommand", 0, &index) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    
+    switch (index) {
+        case THUMB_WANT: {
+            int width, height;
+            Tcl_Size count;
+            Tcl_Obj** specs;
+            if (objc != 5) {
+                Tcl_WrongNumArgs(interp, 2, objv, "specs width height");
+                return TCL_ERROR;
+            }
+            if (Tcl_ListObjGetElements(interp, objv[2], &count, &specs) != TCL_OK ||
+                Tcl_GetIntFromObj(interp, objv[3], &width) != TCL_OK ||
+                Tcl_GetIntFromObj(interp, objv[4], &height) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            std::vector<ThumbnailCache::Request> requests;
+            for (Tcl_Size i = 0; i < count; i++) {
+                Tcl_Size parts;
+                Tcl_Obj** spec;
+                ThumbnailCache::Request request;
+                if (Tcl_ListObjGetElements(interp, specs[i], &parts, &spec) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                if (parts != 2) {
+                    Tcl_SetObjResult(interp, Tcl_NewStringObj("each spec must be {video seconds}", -1));
+                    return TCL_ERROR;
+                }
+                if (Tcl_GetDoubleFromObj(interp, spec[1], &request.seconds) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                request.video = Tcl_GetString(spec[0]);
+                request.width = width;
+                request.height = height;
+                requests.push_back(request);
+            }
+            Tcl_Obj* keys = Tcl_NewListObj(0, nullptr);
+            for (const auto& key : thumbnailCache.want(requests)) {
+                Tcl_ListObjAppendElement(interp, keys, Tcl_NewStringObj(key.c_str(), -1));
+            }
+            Tcl_SetObjResult(interp, keys);
+            break;
+        }
+        case THUMB_PUT: {
+            if (objc != 4) {
+                Tcl_WrongNumArgs(interp, 2, objv, "key photo");
+                return TCL_ERROR;
+            }
+            auto thumbnail = thumbnailCache.get(Tcl_GetString(objv[2]));
+            if (!thumbnail) {
+                Tcl_SetObjResult(interp, Tcl_NewBooleanObj(0));
+                break;
+            }
+            Tk_PhotoHandle photo = Tk_FindPhoto(interp, Tcl_GetString(objv[3]));
+            if (!photo) {
+                Tcl_SetObjResult(interp, Tcl_ObjPrintf("no photo image named \"%s\"", Tcl_GetString(objv[3])));
+                return TCL_ERROR;
+            }
+            Tk_PhotoImageBlock block;
+            block.pixelPtr = const_cast<unsigned char*>(thumbnail->rgb.data());
+            block.width = thumbnail->width;
+            block.height = thumbnail->height;
+            block.pitch = thumbnail->width * 3;
+            block.pixelSize = 3;
+            block.offset[0] = 0;
+            block.offset[1] = 1;
+            block.offset[2] = 2;
+            block.offset[3] = 3;
+            if (Tk_PhotoPutBlock(interp, photo, &block, 0, 0, thumbnail->width, thumbnail->height,
+                                 TK_PHOTO_COMPOSITE_SET) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
+            break;
+        }
+        case THUMB_BUDGET: {
+            if (objc > 3) {
+                Tcl_WrongNumArgs(interp, 2, objv, "?megabytes?");
+                return TCL_ERROR;
+            }
+            if (objc == 3) {
+                int megabytes;
+                if (Tcl_GetIntFromObj(interp, objv[2], &megabytes) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                thumbnailCache.setBudget(static_cast<size_t>(std::max(megabytes, 1)) * 1024 * 1024);
+            }
+            Tcl_SetObjResult(interp, Tcl_NewWideIntObj(thumbnailCache.stats().budget / (1024 * 1024)));
+            break;
+        }
+        case THUMB_STATS: {
+            ThumbnailCache::Stats stats = thumbnailCache.stats();
+            Tcl_Obj* dict = Tcl_NewDictObj();
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("entries", -1), Tcl_NewWideIntObj(stats.entries));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("bytes", -1), Tcl_NewWideIntObj(stats.bytes));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("budget", -1), Tcl_NewWideIntObj(stats.budget));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("pending", -1), Tcl_NewWideIntObj(stats.pending));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("hits", -1), Tcl_NewWideIntObj(stats.hits));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("decoded", -1), Tcl_NewWideIntObj(stats.decoded));
+            Tcl_SetObjResult(interp, dict);
+            break;
+        }
+        case THUMB_CLEAR:
+            thumbnailCache.clear();
+            break;
+    }
+    return TCL_OK;
+}
+
+// Watchdog limits for running renders:
+//   render_limits ?--wall seconds? ?--memory megabytes?
+// A job over either limit is killed and fails with the reason. 0 turns a
+// limit off. Returns the limits now in force as a dict.
+int RenderLimits_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    static const char* options[] = {"--wall", "--memory", nullptr};
+    enum { LIMIT_WALL, LIMIT_MEMORY };
+    
+    if (objc % 2 != 1) {
+        Tcl_WrongNumArgs(interp, 1, objv, "?--wall seconds? ?--memory megabytes?");
+        return TCL_ERROR;
+    }
+    RenderManager::Limits limits = renderManager.getLimits();
+    for (int i = 1; i < objc; i += 2) {
+        int index;
+        double value;
+        if (Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0, &index) != TCL_OK ||
+            Tcl_GetDoubleFromObj(interp, objv[i + 1], &value) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (index == LIMIT_WALL) limits.wall_seconds = value;
+        else limits.memory_kb = static_cast<long>(value * 1024);
+    }
+    renderManager.setLimits(limits);
+    
+    limits = renderManager.getLimits();
+    Tcl_Obj* dict = Tcl_NewDictObj();
+    Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("wall", -1), Tcl_NewDoubleObj(limits.wall_seconds));
+    Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("memory", -1), Tcl_NewWideIntObj(limits.memory_kb / 1024));
+    Tcl_SetObjResult(interp, dict);
+    return TCL_OK;
+}
+
+// Timings of past renders, from the telemetry database:
+//   render_stats ?--last N? ?--by stage|quality|state?
+// Without --by, one dict per render, newest first, with its per-stage
+// seconds in "stages". With --by, one dict per group: key, count, total,
+// mean and max seconds, largest total first.
+int RenderStats_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    static const char* options[] = {"--last", "--by", nullptr};
+    enum { STATS_LAST, STATS_BY };
+    
+    int last = 50;
+    std::string by;
+    if (objc % 2 != 1) {
+        Tcl_WrongNumArgs(interp, 1, objv, "?--last N? ?--by stage|quality|state?");
+        return TCL_ERROR;
+    }
+    for (int i = 1; i < objc; i += 2) {
+        int index;
+        if (Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0, &index) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (index == STATS_LAST) {
+            if (Tcl_GetIntFromObj(interp, objv[i + 1], &last) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (last < 1) last = 1;
         } else {
-            std::cerr << "[C++] Render failed. Output:\n" << result << std::endl;
-            Tcl_SetObjResult(interp, Tcl_NewStringObj(("✗ Render failed: " + result.substr(0, 100)).c_str(), -1));
+            by = Tcl_GetString(objv[i + 1]);
+        }
+    }
+    
+    std::string error;
+    Tcl_Obj* list = Tcl_NewListObj(0, nullptr);
+    if (!by.empty()) {
+        std::vector<RenderTelemetry::Summary> summaries;
+        if (!renderManager.telemetry().summarize(last, by, summaries, error)) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj(error.c_str(), -1));
             return TCL_ERROR;
         }
-        
-    } catch (const std::exception& e) {
-        std::cerr << "[C++] Exception during render: " << e.what() << std::endl;
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(("✗ Error: " + std::string(e.what())).c_str(), -1));
+        for (const auto& summary : summaries) {
+            Tcl_Obj* dict = Tcl_NewDictObj();
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("key", -1), Tcl_NewStringObj(summary.key.c_str(), -1));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("count", -1), Tcl_NewIntObj(summary.count));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("total", -1), Tcl_NewDoubleObj(summary.total));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("mean", -1), Tcl_NewDoubleObj(summary.mean));
+            Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("max", -1), Tcl_NewDoubleObj(summary.max));
+            Tcl_ListObjAppendElement(interp, list, dict);
+        }
+        Tcl_SetObjResult(interp, list);
+        return TCL_OK;
+    }
+    
+    std::vector<RenderTelemetry::Record> records;
+    if (!renderManager.telemetry().recent(last, records, error)) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(error.c_str(), -1));
         return TCL_ERROR;
     }
+    for (const auto& record : records) {
+        Tcl_Obj* stages = Tcl_NewDictObj();
+        for (const auto& stage : record.stages) {
+            Tcl_DictObjPut(interp, stages, Tcl_NewStringObj(stage.first.c_str(), -1), Tcl_NewDoubleObj(stage.second));
+        }
+        Tcl_Obj* dict = Tcl_NewDictObj();
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("job", -1), Tcl_NewIntObj(record.job));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("finished", -1), Tcl_NewWideIntObj(static_cast<Tcl_WideInt>(record.finished)));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("state", -1), Tcl_NewStringObj(record.state.c_str(), -1));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("quality", -1), Tcl_NewStringObj(record.quality.c_str(), -1));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("still", -1), Tcl_NewBooleanObj(record.still));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("equations", -1), Tcl_NewIntObj(record.equations));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("scene_bytes", -1), Tcl_NewWideIntObj(record.scene_bytes));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("cache_hit", -1), Tcl_NewBooleanObj(record.cache_hit));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("segments", -1), Tcl_NewIntObj(record.segments_total));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("segments_rendered", -1), Tcl_NewIntObj(record.segments_rendered));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("queue_seconds", -1), Tcl_NewDoubleObj(record.queue_seconds));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("seconds", -1), Tcl_NewDoubleObj(record.total_seconds));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("cpu_seconds", -1), Tcl_NewDoubleObj(record.cpu_seconds));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("max_rss_kb", -1), Tcl_NewWideIntObj(record.max_rss_kb));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("exit_status", -1), Tcl_NewIntObj(record.exit_status));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("animations", -1), Tcl_NewIntObj(record.work.animations));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("tex_tokens", -1), Tcl_NewIntObj(record.work.tex_tokens));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("estimate", -1), Tcl_NewDoubleObj(record.estimated_seconds));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("stages", -1), stages);
+        Tcl_ListObjAppendElement(interp, list, dict);
+    }
+    Tcl_SetObjResult(interp, list);
+    return TCL_OK;
+}
+
+// Query or set how many Manim processes one render may use:
+//   render_parallel ?processes?
+int RenderParallel_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    if (objc > 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "?processes?");
+        return TCL_ERROR;
+    }
+    if (objc == 2) {
+        int processes;
+        if (Tcl_GetIntFromObj(interp, objv[1], &processes) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        renderManager.setRenderParallelism(processes);
+    }
+    Tcl_SetObjResult(interp, Tcl_NewIntObj(renderManager.renderParallelism()));
+    return TCL_OK;
+}
+
+// Keep a Python with manim already imported around for renders
+void configureRenderWorker() {
+    if (std::ifstream("build/python/manim_worker.py").good()) {
+        renderManager.setWorkerScript("build/python/manim_worker.py");
+    } else {
+        std::cout << "build/python/manim_worker.py not found, rendering with python -m manim" << std::endl;
+    }
+}
+
+// Set by SIGINT/SIGTERM during a batch run; the wait loop then cancels
+volatile sig_atomic_t batchInterrupted = 0;
+
+void onBatchInterrupt(int) {
+    batchInterrupted = 1;
+}
+
+// Seconds between two job timestamps, 0 if either was never set
+double secondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    if (from == std::chrono::steady_clock::time_point() || to == std::chrono::steady_clock::time_point()) return 0.0;
+    return std::chrono::duration<double>(to - from).count();
+}
+
+// Tcl exit handler: the File > Exit menu calls [exit], which never returns
+// to main(), so stop the renders here rather than orphaning Manim
+void shutdownRenders(ClientData) {
+    previewScheduler.stop();
+    videoPlayer.close();
+    thumbnailCache.shutdown();
+    tclEventBridge.detach();
+    renderManager.shutdown();
 }
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -226,11 +966,76 @@ int RenderHandwriting_CPP(ClientData clientData, Tcl_Interp* interp, int objc, T
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Helper function to get render status
+// Helper function to get render status, either overall or for one job
 int GetRenderStatus_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]) {
+    if (objc > 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "?job_id?");
+        return TCL_ERROR;
+    }
+    
+    if (objc == 2) {
+        int job_id;
+        if (Tcl_GetIntFromObj(interp, objv[1], &job_id) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        
+        RenderJob job;
+        if (!renderManager.getJob(job_id, job)) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj(("No render job #" + std::to_string(job_id)).c_str(), -1));
+            return TCL_ERROR;
+        }
+        
+        // Returned as a dict: state message video percent animation frames fps cache segments upgrade
+        // resources duration animations range estimate assets (segments is {rendered total} for segmented renders,
+        // {0 0} otherwise; upgrade is the high quality job of a progressive draft, 0 otherwise;
+        // resources is the latest sample of its processes: processes cpu rss_mb peak_mb read_mb
+        // write_mb; duration is the video's length and animations the second each animation
+        // starts at, once it has finished; range is {first last} of the animations rendered,
+        // counted from 1; estimate is the seconds it was expected to take when first planned, -1
+        // until then or if unknown; assets is what it rebuilds and why, as for render_scene
+        // --explain, empty until it is planned and last planned when it started)
+        Tcl_Obj* dict = Tcl_NewDictObj();
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("state", -1), Tcl_NewStringObj(renderStateName(job.state), -1));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("message", -1), Tcl_NewStringObj(job.message.c_str(), -1));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("video", -1), Tcl_NewStringObj(job.video_path.c_str(), -1));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("percent", -1), Tcl_NewDoubleObj(job.progress.percent));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("animation", -1), Tcl_NewIntObj(job.progress.animation));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("frames", -1), Tcl_NewWideIntObj(job.progress.total_frames));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("fps", -1), Tcl_NewDoubleObj(job.progress.fps));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("cache", -1), Tcl_NewStringObj(job.cache_hit ? "hit" : "miss", -1));
+        Tcl_Obj* segment_counts[2] = {Tcl_NewIntObj(job.segments_rendered), Tcl_NewIntObj(job.segments_total)};
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("segments", -1), Tcl_NewListObj(2, segment_counts));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("upgrade", -1), Tcl_NewIntObj(job.upgrade_job));
+        Tcl_Obj* resources = Tcl_NewDictObj();
+        Tcl_DictObjPut(interp, resources, Tcl_NewStringObj("processes", -1), Tcl_NewIntObj(job.resources.processes));
+        Tcl_DictObjPut(interp, resources, Tcl_NewStringObj("cpu", -1), Tcl_NewDoubleObj(job.resources.cpu_percent));
+        Tcl_DictObjPut(interp, resources, Tcl_NewStringObj("rss_mb", -1), Tcl_NewDoubleObj(job.resources.rss_kb / 1024.0));
+        Tcl_DictObjPut(interp, resources, Tcl_NewStringObj("peak_mb", -1), Tcl_NewDoubleObj(job.resources.peak_rss_kb / 1024.0));
+        Tcl_DictObjPut(interp, resources, Tcl_NewStringObj("read_mb", -1), Tcl_NewDoubleObj(job.resources.read_bytes / 1048576.0));
+        Tcl_DictObjPut(interp, resources, Tcl_NewStringObj("write_mb", -1), Tcl_NewDoubleObj(job.resources.write_bytes / 1048576.0));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("resources", -1), resources);
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("duration", -1), Tcl_NewDoubleObj(job.video_seconds));
+        Tcl_Obj* starts = Tcl_NewListObj(0, nullptr);
+        for (double start : job.animation_starts) {
+            Tcl_ListObjAppendElement(interp, starts, Tcl_NewDoubleObj(start));
+        }
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("animations", -1), starts);
+        Tcl_Obj* range[2] = {Tcl_NewIntObj(job.options.first_animation + 1), Tcl_NewIntObj(job.options.last_animation + 1)};
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("range", -1), Tcl_NewListObj(2, range));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("estimate", -1), Tcl_NewDoubleObj(job.estimated_seconds));
+        Tcl_DictObjPut(interp, dict, Tcl_NewStringObj("assets", -1), assetDecisionList(interp, job.assets));
+        Tcl_SetObjResult(interp, dict);
+        return TCL_OK;
+    }
+    
     std::string status = "Ready";
-    if (!equations.empty()) {
-        status += " (" + std::to_string(equations.size()) + " equations)";
+    size_t equation_count = sceneManager.getEquations().size();
+    if (equation_count > 0) {
+        status += " (" + std::to_string(equation_count) + " equations)";
+    }
+    int active = renderManager.activeJobCount();
+    if (active > 0) {
+        status += ", " + std::to_string(active) + " render(s) in progress";
     }
     Tcl_SetObjResult(interp, Tcl_NewStringObj(status.c_str(), -1));
     return TCL_OK;
@@ -252,10 +1057,26 @@ int AddEquation_CPP(ClientData clientData, Tcl_Interp* interp, int objc, Tcl_Obj
         return TCL_ERROR;
     }
     
+    // Reject LaTeX that TeX would choke on before it gets into the scene
+    std::vector<LatexIssue> issues = LatexValidator::check(latex);
+    if (LatexValidator::hasErrors(issues)) {
+        std::string message = "Invalid LaTeX";
+        for (const auto& issue : issues) {
+            if (issue.severity == LatexIssue::Error) message += "\n" + LatexValidator::describe(issue);
+        }
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(message.c_str(), -1));
+        return TCL_ERROR;
+    }
+    
     int eq_id = sceneManager.addEquation(latex, x, y);
     std::cout << "[C++] Added equation #" << eq_id << ": " << latex << std::endl;
     
-    Tcl_SetObjResult(interp, Tcl_NewStringObj(("Equation #" + std::to_string(eq_id) + " added").c_str(), -1));
+    std::string result = "Equation #" + std::to_string(eq_id) + " added";
+    for (const auto& issue : issues) {
+        std::cout << "[C++] Equation #" << eq_id << " warning at " << LatexValidator::describe(issue) << std::endl;
+        result += " (warning: " + issue.message + ")";
+    }
+    Tcl_SetObjResult(interp, Tcl_NewStringObj(result.c_str(), -1));
     return TCL_OK;
 }
 
@@ -310,6 +1131,51 @@ public:
         global_interp = m_interp;
         handwritingRenderer.setTclCallback(tclCallback);
         
+        // Render results arrive on worker threads; forward them to the GUI
+        tclEventBridge.attach(m_interp);
+        renderManager.setFinishedCallback([](const RenderJob& job) {
+            if (job.options.still_frame) {
+                // Superseded previews are never shown
+                if (job.id != previewScheduler.currentJob()) return;
+                tclEventBridge.post({"render_preview_finished", std::to_string(job.id),
+                                     renderStateName(job.state),
+                                     job.message, job.video_path});
+                return;
+            }
+            tclEventBridge.post({"render_job_finished", std::to_string(job.id),
+                                 renderStateName(job.state),
+                                 job.message, job.video_path});
+        });
+        renderManager.setSegmentCallback([](int job_id, int index, int count, const std::string& clip) {
+            tclEventBridge.post({"render_segment_ready", std::to_string(job_id), std::to_string(index),
+                                 std::to_string(count), clip});
+        });
+        renderManager.setPlannedCallback([](int job_id, double estimated_seconds) {
+            tclEventBridge.post({"render_job_planned", std::to_string(job_id), std::to_string(estimated_seconds)});
+        });
+        renderManager.setProgressCallback([](int job_id, const RenderProgress& progress) {
+            char fps[32];
+            snprintf(fps, sizeof(fps), "%.1f", progress.fps);
+            tclEventBridge.post({"render_job_progress", std::to_string(job_id),
+                                 std::to_string(static_cast<int>(progress.percent)),
+                                 std::to_string(progress.animation + 1),
+                                 std::to_string(progress.animation_count),
+                                 std::to_string(progress.frame),
+                                 std::to_string(progress.frame_count),
+                                 fps});
+        });
+        Tcl_CreateExitHandler(shutdownRenders, nullptr);
+        sceneManager.setChangeCallback([] { previewScheduler.sceneChanged(); });
+        videoPlayer.setFrameCallback([](int frame, int frame_count) {
+            tclEventBridge.post({"player_frame_shown", std::to_string(frame), std::to_string(frame_count)});
+        });
+        videoPlayer.setEndCallback([] { tclEventBridge.post({"player_finished"}); });
+        thumbnailCache.setReadyCallback([](const std::string& key, bool ok) {
+            tclEventBridge.post({"timeline_thumbnail_ready", key, ok ? "1" : "0"});
+        });
+        
+        configureRenderWorker();
+        
         std::cout << "Tcl/Tk initialized successfully!" << std::endl;
         return 1;
     }
@@ -326,16 +1192,30 @@ public:
         Tcl_CreateObjCommand(m_interp, "list_equations", ListEquations_CPP, nullptr, nullptr);
         ///////////////////////////////////////////////////////////////////////////////////////////////////    
         Tcl_CreateObjCommand(m_interp, "render_scene", RenderScene_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "render_estimate", RenderEstimate_CPP, nullptr, nullptr);
         Tcl_CreateObjCommand(m_interp, "get_render_status", GetRenderStatus_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "cancel_render", CancelRender_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "render_cache", RenderCache_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "render_parallel", RenderParallel_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "render_queue", RenderQueue_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "render_preview", RenderPreview_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "render_stats", RenderStats_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "render_limits", RenderLimits_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "video_player", VideoPlayer_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "timeline_thumbnail", TimelineThumbnail_CPP, nullptr, nullptr);
         Tcl_CreateObjCommand(m_interp, "clear_all_equations", ClearEquations_CPP, nullptr, nullptr);
         ///////////////////////////////////////////////////////////////////////////////////////////////////        
         Tcl_CreateObjCommand(m_interp, "render_handwriting", RenderHandwriting_CPP, nullptr, nullptr);
         ///////////////////////////////////////////////////////////////////////////////////////////////////
         // Also add a test command
         Tcl_CreateObjCommand(m_interp, "test_render_setup", [](ClientData, Tcl_Interp* interp, int, Tcl_Obj* const[]) -> int {
-            // Test if Manim is available
-            int result = system("python -c \"import manim; print('Manim found:', manim.__version__)\" 2>&1");
-            Tcl_SetObjResult(interp, Tcl_NewStringObj((result == 0) ? "Manim is ready" : "Manim not found", -1));
+            // Test if Manim is available; with warm workers this also starts one
+            std::string version;
+            bool found = renderManager.checkManim(version);
+            std::cout << "Manim found: " << (found ? version : "no") << std::endl;
+            std::string message = found ? "Manim is ready (" + version + ")"
+                                : version.empty() ? "Manim not found" : "Manim not found: " + version;
+            Tcl_SetObjResult(interp, Tcl_NewStringObj(message.c_str(), -1));
             return TCL_OK;
         }, nullptr, nullptr);
         ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -385,7 +1265,194 @@ public:
         return 0;
     }
     /////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Headless mode for unattended renders:
+    //   AmrMathMaker --batch <project.tcl>... ?--jobs N? ?--quality -ql|-qm|-qh? ?--summary file?
+    //                ?--timeout seconds?
+    // A project is a Tcl script of add_equation calls, evaluated in an
+    // interpreter without Tk. Up to N projects render at once; one that
+    // runs past --timeout is killed and fails. A JSON summary goes to
+    // stdout (or the --summary file) and all logging to stderr. Exits 0
+    // only if every project rendered.
+    int run_batch() {
+        std::vector<std::string> projects;
+        int jobs = 1;
+        std::string quality = "-ql";
+        std::string summary_path = "-";
+        double timeout = 0.0;
+        bool usage_error = false;
+        for (int i = 2; i < m_argc; i++) {
+            std::string arg = m_argv[i];
+            if (arg == "--jobs" || arg == "--quality" || arg == "--summary" || arg == "--timeout") {
+                if (i + 1 >= m_argc) {
+                    usage_error = true;
+                    break;
+                }
+                std::string value = m_argv[++i];
+                if (arg == "--jobs") jobs = std::atoi(value.c_str());
+                else if (arg == "--quality") quality = value;
+                else if (arg == "--timeout") timeout = std::atof(value.c_str());
+                else summary_path = value;
+            } else if (arg.rfind("--", 0) == 0) {
+                usage_error = true;
+            } else {
+                projects.push_back(arg);
+            }
+        }
+        if (usage_error || projects.empty() || jobs < 1 || timeout < 0) {
+            std::cerr << "usage: " << m_argv[0]
+                      << " --batch <project.tcl>... ?--jobs N? ?--quality -ql|-qm|-qh? ?--summary file?"
+                      << " ?--timeout seconds?" << std::endl;
+            return 2;
+        }
+        
+        // stdout carries only the summary
+        std::streambuf* stdout_buf = std::cout.rdbuf(std::cerr.rdbuf());
+        
+        Tcl_FindExecutable(m_argv[0]);
+        m_interp = Tcl_CreateInterp();
+        if (Tcl_Init(m_interp) != TCL_OK) {
+            std::cout << "Tcl_Init failed, projects get the core commands only: "
+                      << Tcl_GetStringResult(m_interp) << std::endl;
+        }
+        Tcl_CreateObjCommand(m_interp, "add_equation", AddEquation_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "list_equations", ListEquations_CPP, nullptr, nullptr);
+        Tcl_CreateObjCommand(m_interp, "clear_all_equations", ClearEquations_CPP, nullptr, nullptr);
+        
+        // N projects share the cores rather than each taking all of them;
+        // the render manager splits its parallelism between running jobs
+        int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        renderManager.setMaxConcurrent(jobs);
+        renderManager.setRenderParallelism(cores);
+        configureRenderWorker();
+        // Nobody is watching: a hung render must not hold the batch forever
+        RenderManager::Limits limits = renderManager.getLimits();
+        limits.wall_seconds = timeout;
+        renderManager.setLimits(limits);
+        
+        std::mutex done_mutex;
+        std::condition_variable done_cv;
+        std::map<int, RenderJob> finished;
+        renderManager.setFinishedCallback([&](const RenderJob& job) {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            finished.emplace(job.id, job);
+            std::cout << "[Batch] Job #" << job.id << " " << renderStateName(job.state) << ": " << job.message << std::endl;
+            done_cv.notify_all();
+        });
+        
+        std::signal(SIGINT, onBatchInterrupt);
+        std::signal(SIGTERM, onBatchInterrupt);
+        auto batch_start = std::chrono::steady_clock::now();
+        
+        // Project path -> job id, or the reason it never got one
+        std::vector<int> job_ids(projects.size(), 0);
+        std::vector<size_t> equation_counts(projects.size(), 0);
+        std::vector<std::string> load_errors(projects.size());
+        int submitted = 0;
+        for (size_t i = 0; i < projects.size() && !batchInterrupted; i++) {
+            sceneManager.clearAll();
+            if (Tcl_EvalFile(m_interp, projects[i].c_str()) != TCL_OK) {
+                load_errors[i] = std::string("Could not load project: ") + Tcl_GetStringResult(m_interp);
+                std::cout << "[Batch] " << projects[i] << ": " << load_errors[i] << std::endl;
+                continue;
+            }
+            std::vector<MathEquation> equations = sceneManager.snapshot();
+            equation_counts[i] = equations.size();
+            if (equations.empty()) {
+                load_errors[i] = "Project has no equations";
+                std::cout << "[Batch] " << projects[i] << ": " << load_errors[i] << std::endl;
+                continue;
+            }
+            
+            RenderOptions options;
+            options.quality = quality;
+            options.filename = std::filesystem::path(projects[i]).stem().string();
+            options.priority = RENDER_PRIORITY_EXPORT;
+            job_ids[i] = renderManager.submit(options, std::move(equations));
+            submitted++;
+        }
+        
+        {
+            std::unique_lock<std::mutex> lock(done_mutex);
+            while (finished.size() < static_cast<size_t>(submitted)) {
+                if (batchInterrupted) {
+                    lock.unlock();
+                    std::cout << "[Batch] Interrupted, cancelling renders" << std::endl;
+                    renderManager.shutdown();
+                    lock.lock();
+                    break;
+                }
+                done_cv.wait_for(lock, std::chrono::milliseconds(200));
+            }
+        }
+        renderManager.shutdown();
+        renderManager.setFinishedCallback(nullptr);
+        double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - batch_start).count();
+        
+        // The summary: one object per project in command line order
+        std::ostringstream summary;
+        int succeeded = 0, failed = 0, cancelled = 0;
+        char number[32];
+        summary << "{\"projects\": [";
+        for (size_t i = 0; i < projects.size(); i++) {
+            std::string state = "failed";
+            std::string message = load_errors[i];
+            std::string video;
+            bool cache_hit = false;
+            double queue_seconds = 0.0, render_seconds = 0.0;
+            auto it = finished.find(job_ids[i]);
+            if (job_ids[i] != 0 && it != finished.end()) {
+                const RenderJob& job = it->second;
+                state = renderStateName(job.state);
+                message = job.message;
+                video = job.video_path;
+                cache_hit = job.cache_hit;
+                queue_seconds = secondsBetween(job.submitted_at, job.started_at);
+                render_seconds = secondsBetween(job.started_at, job.finished_at);
+            } else if (job_ids[i] != 0 || message.empty()) {
+                state = "cancelled";
+                message = "Batch interrupted";
+            }
+            if (state == "done") succeeded++;
+            else if (state == "cancelled") cancelled++;
+            else failed++;
+            
+            summary << (i ? ",\n  " : "\n  ") << "{\"project\": " << jsonQuote(projects[i])
+                    << ", \"state\": " << jsonQuote(state)
+                    << ", \"job\": " << (job_ids[i] ? std::to_string(job_ids[i]) : "null")
+                    << ", \"equations\": " << equation_counts[i];
+            snprintf(number, sizeof(number), "%.3f", queue_seconds);
+            summary << ", \"queue_seconds\": " << number;
+            snprintf(number, sizeof(number), "%.3f", render_seconds);
+            summary << ", \"render_seconds\": " << number
+                    << ", \"cache_hit\": " << (cache_hit ? "true" : "false")
+                    << ", \"video\": " << jsonQuote(video)
+                    << ", \"message\": " << jsonQuote(message) << "}";
+        }
+        snprintf(number, sizeof(number), "%.3f", wall_seconds);
+        summary << "\n], \"succeeded\": " << succeeded << ", \"failed\": " << failed
+                << ", \"cancelled\": " << cancelled << ", \"jobs\": " << jobs
+                << ", \"wall_seconds\": " << number << "}\n";
+        
+        std::cout.rdbuf(stdout_buf);
+        if (summary_path == "-") {
+            std::cout << summary.str() << std::flush;
+        } else {
+            std::ofstream out(summary_path);
+            out << summary.str();
+            if (!out) {
+                std::cerr << "Could not write summary to " << summary_path << std::endl;
+                return 1;
+            }
+        }
+        
+        Tcl_DeleteInterp(m_interp);
+        return succeeded == static_cast<int>(projects.size()) ? 0 : 1;
+    }
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
     int cleanup() {
+        // Stop in-flight renders before the interpreter goes away
+        Tcl_DeleteExitHandler(shutdownRenders, nullptr);
+        shutdownRenders(nullptr);
         Tcl_DeleteInterp(m_interp);
     }
     
@@ -394,6 +1461,12 @@ public:
 int main(int argc, char* argv[]) {
 
     AmrMathMakerApp app(argc, argv);    
+    
+    // Unattended renders never touch Tk or the GUI script
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        return app.run_batch();
+    }
+    
     app.initialize_tcl_tk();
     
     app.register_cpp_funcs_as_tcl_commands();